@@ -0,0 +1,668 @@
+//
+//  bench_main.cpp
+//  bench
+//
+//  Throughput of stdx containers and string operations compared with hand-written std equivalents.
+//  Usage: stdx_bench [--filter <substring>] [--min-time <seconds>]
+//
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cctype>
+#include <charconv>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <new>
+#include <random>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <stdx/concurrent_fixed_histogram.hpp>
+#include <stdx/convert.hpp>
+#include <stdx/fixed_soa_vector.hpp>
+#include <stdx/fixed_vector.hpp>
+#include <stdx/mapped_fixed_vector.hpp>
+#include <stdx/parallel.hpp>
+#include <stdx/string.hpp>
+#include <stdx/string_pool.hpp>
+#include <stdx/utf.hpp>
+
+/* Allocation counting. Every allocation made by the process goes through these.
+ * Kept out of line, so the compiler does not pair inlined calls to malloc and free with library allocations. */
+static std::atomic<uint64_t> allocation_count{0};
+
+__attribute__((noinline)) void* operator new(std::size_t size) {
+  allocation_count.fetch_add(1, std::memory_order_relaxed);
+  if (void* p = std::malloc(size == 0 ? 1 : size)) { return p; }
+  throw std::bad_alloc();
+}
+__attribute__((noinline)) void operator delete(void* p) noexcept { std::free(p); }
+__attribute__((noinline)) void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+namespace {
+
+/** Prevent the compiler from optimising away a computed value. */
+template <class T>
+inline void do_not_optimize(const T& value) {
+  asm volatile("" : : "r,m"(value) : "memory");
+}
+
+struct options {
+  std::string filter;
+  double min_time = 0.25;
+};
+
+/** Run \p body repeatedly for at least the minimum time, and report per-iteration time, throughput and allocations. */
+void run(const options& opts, const std::string& name, double bytes_per_iter, double elems_per_iter, const std::function<void()>& body) {
+  if (!opts.filter.empty() && name.find(opts.filter) == std::string::npos) { return; }
+  using clock = std::chrono::steady_clock;
+  body(); // Warm up
+  uint64_t iterations = 0;
+  uint64_t allocations_before = allocation_count.load(std::memory_order_relaxed);
+  auto start = clock::now();
+  double elapsed = 0;
+  uint64_t batch = 1;
+  while (elapsed < opts.min_time) {
+    for (uint64_t i = 0; i < batch; ++i) { body(); }
+    iterations += batch;
+    batch *= 2;
+    elapsed = std::chrono::duration<double>(clock::now() - start).count();
+  }
+  uint64_t allocations = allocation_count.load(std::memory_order_relaxed) - allocations_before;
+  const double seconds_per_iter = elapsed / static_cast<double>(iterations);
+  std::printf("%-44s %12.1f ns %12.1f MB/s %12.2f Melem/s %12.2f allocs\n", name.c_str(), seconds_per_iter * 1e9,
+              bytes_per_iter / seconds_per_iter / 1e6, elems_per_iter / seconds_per_iter / 1e6,
+              static_cast<double>(allocations) / static_cast<double>(iterations));
+}
+
+/* Corpora */
+struct corpus {
+  std::string name;
+  std::vector<std::string> lines;
+  double bytes = 0;
+};
+
+std::string random_token(std::mt19937& rng, int min_length, int max_length) {
+  std::uniform_int_distribution<int> length(min_length, max_length), letter('a', 'z');
+  std::string token(static_cast<std::size_t>(length(rng)), ' ');
+  for (char& c : token) { c = static_cast<char>(letter(rng)); }
+  return token;
+}
+
+corpus make_corpus(const std::string& name, int lines, int fields, int min_token, int max_token, int padding, char separator) {
+  std::mt19937 rng(42);
+  corpus result{name, {}, 0};
+  for (int l = 0; l < lines; ++l) {
+    std::string line(static_cast<std::size_t>(padding), ' ');
+    for (int f = 0; f < fields; ++f) {
+      if (f > 0) { line += separator == ' ' ? std::string(static_cast<std::size_t>(1 + padding), ' ') : std::string(1, separator); }
+      line += random_token(rng, min_token, max_token);
+    }
+    line += std::string(static_cast<std::size_t>(padding), ' ');
+    result.bytes += static_cast<double>(line.size());
+    result.lines.push_back(std::move(line));
+  }
+  return result;
+}
+
+double count_fields(const corpus& c, char separator) {
+  double total = 0;
+  for (const std::string& line : c.lines) {
+    stdx::split_view tokens(line, separator, separator < 0);
+    total += static_cast<double>(std::distance(tokens.begin(), tokens.end()));
+  }
+  return total;
+}
+
+/* Hand-written std equivalents */
+void std_split_whitespace(const std::string& s, std::vector<std::string>& out) {
+  static const char* whitespace = " \f\n\r\t\v";
+  std::size_t idx = 0;
+  while (idx < s.size()) {
+    std::size_t start = s.find_first_not_of(whitespace, idx);
+    if (start == std::string::npos) { break; }
+    std::size_t end = s.find_first_of(whitespace, start);
+    out.push_back(s.substr(start, end == std::string::npos ? std::string::npos : end - start));
+    idx = end;
+  }
+}
+void std_split_char(const std::string& s, char separator, std::vector<std::string>& out) {
+  std::size_t previous = 0, pos;
+  while ((pos = s.find(separator, previous)) != std::string::npos) {
+    out.push_back(s.substr(previous, pos - previous));
+    previous = pos + 1;
+  }
+  out.push_back(s.substr(previous));
+}
+std::string std_strip(const std::string& s) {
+  static const char* whitespace = " \f\n\r\t\v";
+  std::size_t left = s.find_first_not_of(whitespace);
+  if (left == std::string::npos) { return std::string(); }
+  return s.substr(left, s.find_last_not_of(whitespace) - left + 1);
+}
+std::string std_join(const std::vector<std::string>& parts, const std::string& separator) {
+  std::string result;
+  for (std::size_t i = 0; i < parts.size(); ++i) {
+    if (i > 0) { result += separator; }
+    result += parts[i];
+  }
+  return result;
+}
+
+/* Benchmarks */
+void bench_split_whitespace(const options& opts, const std::vector<corpus>& corpora) {
+  for (const corpus& c : corpora) {
+    std::vector<stdx::string> lines(c.lines.begin(), c.lines.end());
+    const double fields = count_fields(c, -1);
+    std::vector<stdx::string> out;
+    std::vector<std::string> std_out;
+    run(opts, "split/whitespace/stdx/" + c.name, c.bytes, fields, [&] {
+      for (const stdx::string& line : lines) { out.clear(); line.split(std::back_inserter(out)); do_not_optimize(out.data()); }
+    });
+    run(opts, "split/whitespace/stdx_lazy/" + c.name, c.bytes, fields, [&] {
+      std::size_t total = 0;
+      for (const stdx::string& line : lines) { for (auto token : line.split_lazy()) { total += token.size(); } }
+      do_not_optimize(total);
+    });
+    std::vector<std::string_view> views;
+    run(opts, "split/whitespace/view_ex/" + c.name, c.bytes, fields, [&] {
+      for (const std::string& line : c.lines) { views.clear(); stdx::string_view_ex(line).split(std::back_inserter(views)); do_not_optimize(views.data()); }
+    });
+    run(opts, "split/whitespace/std/" + c.name, c.bytes, fields, [&] {
+      for (const std::string& line : c.lines) { std_out.clear(); std_split_whitespace(line, std_out); do_not_optimize(std_out.data()); }
+    });
+  }
+}
+
+void bench_split_keep_empty(const options& opts, const std::vector<corpus>& corpora) {
+  for (const corpus& c : corpora) {
+    std::vector<stdx::string> lines(c.lines.begin(), c.lines.end());
+    const double fields = count_fields(c, ',');
+    std::vector<stdx::string> out;
+    std::vector<std::string> std_out;
+    run(opts, "split/keep_empty/stdx/" + c.name, c.bytes, fields, [&] {
+      for (const stdx::string& line : lines) { out.clear(); line.split(std::back_inserter(out), ',', false); do_not_optimize(out.data()); }
+    });
+    run(opts, "split/keep_empty/stdx_lazy/" + c.name, c.bytes, fields, [&] {
+      std::size_t total = 0;
+      for (const stdx::string& line : lines) { for (auto token : line.split_lazy(',', false)) { total += token.size(); } }
+      do_not_optimize(total);
+    });
+    run(opts, "split/keep_empty/std/" + c.name, c.bytes, fields, [&] {
+      for (const std::string& line : c.lines) { std_out.clear(); std_split_char(line, ',', std_out); do_not_optimize(std_out.data()); }
+    });
+  }
+}
+
+void bench_strip(const options& opts, const std::vector<corpus>& corpora) {
+  for (const corpus& c : corpora) {
+    std::vector<stdx::string> lines(c.lines.begin(), c.lines.end());
+    const double count = static_cast<double>(lines.size());
+    run(opts, "strip/stdx/" + c.name, c.bytes, count, [&] {
+      for (const stdx::string& line : lines) { stdx::string s = line.strip(); do_not_optimize(s.data()); }
+    });
+    run(opts, "strip/view_ex/" + c.name, c.bytes, count, [&] {
+      for (const std::string& line : c.lines) { stdx::string_view_ex s = stdx::string_view_ex(line).strip(); do_not_optimize(s.data()); }
+    });
+    run(opts, "strip/std/" + c.name, c.bytes, count, [&] {
+      for (const std::string& line : c.lines) { std::string s = std_strip(line); do_not_optimize(s.data()); }
+    });
+    run(opts, "lstrip/stdx/" + c.name, c.bytes, count, [&] {
+      for (const stdx::string& line : lines) { stdx::string s = line.lstrip(); do_not_optimize(s.data()); }
+    });
+    run(opts, "rstrip/stdx/" + c.name, c.bytes, count, [&] {
+      for (const stdx::string& line : lines) { stdx::string s = line.rstrip(); do_not_optimize(s.data()); }
+    });
+    std::vector<stdx::string> scratch = lines;
+    run(opts, "strip_inplace/stdx/" + c.name, c.bytes, count, [&] {
+      for (std::size_t i = 0; i < lines.size(); ++i) { scratch[i] = lines[i]; scratch[i].strip_inplace(); }
+      do_not_optimize(scratch.data());
+    });
+  }
+}
+
+void bench_join(const options& opts, const std::vector<corpus>& corpora) {
+  for (const corpus& c : corpora) {
+    std::vector<std::string> parts;
+    std_split_whitespace(c.lines.front(), parts);
+    double bytes = 0;
+    for (const std::string& part : parts) { bytes += static_cast<double>(part.size()); }
+    const stdx::string separator(", ");
+    run(opts, "join/stdx/" + c.name, bytes, static_cast<double>(parts.size()), [&] {
+      stdx::string s = separator.join(parts.begin(), parts.end());
+      do_not_optimize(s.data());
+    });
+    run(opts, "join/std/" + c.name, bytes, static_cast<double>(parts.size()), [&] {
+      std::string s = std_join(parts, separator);
+      do_not_optimize(s.data());
+    });
+  }
+}
+
+void bench_replace(const options& opts) {
+  std::mt19937 rng(11);
+  const std::vector<std::string> needles = {"alpha", "beta", "gamma", "delta", "epsilon", "zeta", "eta", "theta"};
+  const std::vector<std::string> replacements = {"A", "B", "G", "D", "E", "Z", "H", "T"};
+  std::string payload;
+  while (payload.size() < (1u << 20)) {
+    payload += (rng() % 4 == 0) ? needles[rng() % needles.size()] : random_token(rng, 3, 9);
+    payload += ' ';
+  }
+  const stdx::string text(payload);
+  const double bytes = static_cast<double>(text.size());
+  run(opts, "replace/single/stdx", bytes, 1, [&] {
+    stdx::string s = text.replace("beta", "BETA!");
+    do_not_optimize(s.data());
+  });
+  run(opts, "replace/single/std_find_replace", bytes, 1, [&] {
+    std::string s = payload;
+    for (std::size_t pos = s.find("beta"); pos != std::string::npos; pos = s.find("beta", pos + 5)) { s.replace(pos, 4, "BETA!"); }
+    do_not_optimize(s.data());
+  });
+  const stdx::multi_pattern patterns(needles.begin(), needles.end());
+  run(opts, "replace/multi/stdx_multi_pattern", bytes, 1, [&] {
+    stdx::string s = text.replace(patterns, replacements);
+    do_not_optimize(s.data());
+  });
+  run(opts, "replace/multi/std_find_replace", bytes, 1, [&] {
+    std::string s = payload;
+    for (std::size_t n = 0; n < needles.size(); ++n) {
+      for (std::size_t pos = s.find(needles[n]); pos != std::string::npos; pos = s.find(needles[n], pos + replacements[n].size())) {
+        s.replace(pos, needles[n].size(), replacements[n]);
+      }
+    }
+    do_not_optimize(s.data());
+  });
+  run(opts, "count/multi/stdx_multi_pattern", bytes, 1, [&] { do_not_optimize(text.count(patterns)); });
+  run(opts, "count/multi/std_find", bytes, 1, [&] {
+    std::size_t total = 0;
+    for (const std::string& needle : needles) {
+      for (std::size_t pos = payload.find(needle); pos != std::string::npos; pos = payload.find(needle, pos + needle.size())) { ++total; }
+    }
+    do_not_optimize(total);
+  });
+}
+
+void bench_case(const options& opts) {
+  std::mt19937 rng(13);
+  std::string payload;
+  while (payload.size() < (1u << 16)) { payload += random_token(rng, 3, 12) + "-Header: Value\r\n"; }
+  const stdx::string text(payload);
+  const double bytes = static_cast<double>(text.size());
+  stdx::string buffer(text);
+  run(opts, "case/lower_inplace/stdx", bytes, bytes, [&] {
+    buffer.upper_inplace().lower_inplace();
+    do_not_optimize(buffer.data());
+  });
+  std::string plain(payload);
+  run(opts, "case/lower_inplace/std_tolower", bytes, bytes, [&] {
+    for (char& c : plain) { c = static_cast<char>(std::toupper(static_cast<unsigned char>(c))); }
+    for (char& c : plain) { c = static_cast<char>(std::tolower(static_cast<unsigned char>(c))); }
+    do_not_optimize(plain.data());
+  });
+
+  const std::vector<std::string> names = {"Content-Type", "Content-Length", "Host", "User-Agent", "Accept", "Accept-Encoding",
+                                          "Connection", "Cache-Control", "Authorization", "X-Request-Id"};
+  std::vector<std::string> queries;
+  for (int i = 0; i < 1000; ++i) {
+    std::string query = names[rng() % names.size()];
+    for (char& c : query) { if (rng() % 2) { c = static_cast<char>(std::toupper(static_cast<unsigned char>(c))); } }
+    queries.push_back(query);
+  }
+  std::unordered_map<std::string, int, stdx::ihash, stdx::iequal_to> caseless;
+  std::unordered_map<std::string, int> normalised;
+  for (std::size_t i = 0; i < names.size(); ++i) {
+    caseless.emplace(names[i], static_cast<int>(i));
+    normalised.emplace(stdx::string(names[i]).lower(), static_cast<int>(i));
+  }
+  run(opts, "case/lookup/stdx_ihash", 0, static_cast<double>(queries.size()), [&] {
+    int total = 0;
+    for (const std::string& query : queries) { total += caseless.find(query)->second; }
+    do_not_optimize(total);
+  });
+  run(opts, "case/lookup/std_normalised_copy", 0, static_cast<double>(queries.size()), [&] {
+    int total = 0;
+    for (const std::string& query : queries) {
+      std::string key(query);
+      for (char& c : key) { c = static_cast<char>(std::tolower(static_cast<unsigned char>(c))); }
+      total += normalised.find(key)->second;
+    }
+    do_not_optimize(total);
+  });
+}
+
+void bench_intern(const options& opts) {
+  // Many fields drawn from few distinct values
+  std::mt19937 rng(17);
+  std::vector<std::string> values;
+  for (int i = 0; i < 2000; ++i) { values.push_back(random_token(rng, 16, 40)); }
+  std::vector<stdx::string> lines;
+  double bytes = 0, fields = 0;
+  for (int l = 0; l < 2000; ++l) {
+    std::string line;
+    for (int f = 0; f < 16; ++f, ++fields) { line += values[rng() % values.size()] + ' '; }
+    bytes += static_cast<double>(line.size());
+    lines.emplace_back(line);
+  }
+  std::vector<stdx::string> tokens;
+  run(opts, "intern/split_strings", bytes, fields, [&] {
+    tokens.clear();
+    for (const stdx::string& line : lines) { line.split(std::back_inserter(tokens)); }
+    do_not_optimize(tokens.data());
+  });
+  std::vector<stdx::inline_string<40>> keys;
+  run(opts, "intern/split_inline_strings", bytes, fields, [&] {
+    keys.clear();
+    for (const stdx::string& line : lines) {
+      for (std::string_view token : line.split_lazy()) { keys.emplace_back(token); }
+    }
+    do_not_optimize(keys.data());
+  });
+  std::vector<stdx::string_pool::id_type> ids;
+  stdx::string_pool pool;
+  run(opts, "intern/split_string_pool", bytes, fields, [&] {
+    ids.clear();
+    for (const stdx::string& line : lines) { line.split(std::back_inserter(ids), pool); }
+    do_not_optimize(ids.data());
+  });
+  stdx::concurrent_string_pool shared_pool;
+  run(opts, "intern/split_concurrent_string_pool", bytes, fields, [&] {
+    ids.clear();
+    for (const stdx::string& line : lines) { line.split(std::back_inserter(ids), shared_pool); }
+    do_not_optimize(ids.data());
+  });
+}
+
+void bench_utf(const options& opts) {
+  // Mostly ASCII payload with some Latin-1, CJK and emoji, and Unicode spaces between some words
+  std::mt19937 rng(19);
+  const char* const extras[] = {u8"caf\u00e9", u8"\u4e16\u754c", u8"\U0001F600", u8"na\u00efve"};
+  const char* const spaces[] = {" ", " ", " ", "\t", u8"\u00a0", u8"\u3000"};
+  std::string payload;
+  while (payload.size() < (1u << 16)) {
+    payload += (rng() % 8 == 0) ? std::string(extras[rng() % 4]) : random_token(rng, 2, 10);
+    payload += spaces[rng() % 6];
+  }
+  const stdx::string text(payload);
+  const double bytes = static_cast<double>(text.size());
+  const double code_points = static_cast<double>(stdx::utf8_length(text));
+
+  run(opts, "utf/validate/stdx", bytes, bytes, [&] { do_not_optimize(stdx::is_valid_utf8(text)); });
+  run(opts, "utf/validate/bytewise", bytes, bytes, [&] {
+    const unsigned char* s = reinterpret_cast<const unsigned char*>(text.data());
+    std::size_t i = 0, length = 1;
+    while (i < text.size() && (length = stdx::detail::utf8_sequence_length(s + i, text.size() - i)) != 0) { i += length; }
+    do_not_optimize(i);
+  });
+  run(opts, "utf/utf8_to_utf16/stdx", bytes, code_points, [&] {
+    const std::u16string out = stdx::utf8_to_utf16(text);
+    do_not_optimize(out.data());
+  });
+  run(opts, "utf/utf8_to_utf16/push_back", bytes, code_points, [&] {
+    std::u16string out;
+    char16_t units[2];
+    for (std::size_t i = 0; i < text.size();) {
+      const char32_t cp = stdx::detail::utf_decode(text.data(), text.size(), i);
+      out.append(units, stdx::detail::utf_encode(cp, units));
+    }
+    do_not_optimize(out.data());
+  });
+
+  std::vector<std::string_view> tokens;
+  run(opts, "utf/split_whitespace/stdx", bytes, code_points, [&] {
+    tokens.clear();
+    for (std::string_view token : text.split_lazy(stdx::utf8_whitespace)) { tokens.push_back(token); }
+    do_not_optimize(tokens.data());
+  });
+  std::vector<std::u32string> decoded_tokens;
+  run(opts, "utf/split_whitespace/decode_first", bytes, code_points, [&] {
+    decoded_tokens.clear();
+    const stdx::u32string decoded = text.to_utf32();
+    decoded.split(std::back_inserter(decoded_tokens), stdx::char_classes<char32_t>::unicode_whitespace);
+    do_not_optimize(decoded_tokens.data());
+  });
+}
+
+void bench_convert(const options& opts) {
+  std::mt19937 rng(7);
+  std::uniform_int_distribution<int64_t> ints(-1000000000, 1000000000);
+  std::uniform_real_distribution<double> reals(-1e6, 1e6);
+  std::vector<stdx::string> int_tokens, real_tokens;
+  double int_bytes = 0, real_bytes = 0;
+  for (int i = 0; i < 10000; ++i) {
+    int_tokens.emplace_back(std::to_string(ints(rng)));
+    real_tokens.emplace_back(std::to_string(reals(rng)));
+    int_bytes += static_cast<double>(int_tokens.back().size());
+    real_bytes += static_cast<double>(real_tokens.back().size());
+  }
+  const double count = static_cast<double>(int_tokens.size());
+  run(opts, "convert/int64/stdx_convert", int_bytes, count, [&] {
+    int64_t total = 0;
+    for (const stdx::string& token : int_tokens) { total += token.convert<int64_t>(); }
+    do_not_optimize(total);
+  });
+  run(opts, "convert/int64/stdx_checked", int_bytes, count, [&] {
+    int64_t total = 0;
+    for (const stdx::string& token : int_tokens) { total += stdx::convert<int64_t>(token).value; }
+    do_not_optimize(total);
+  });
+  run(opts, "convert/int64/std_strtoll", int_bytes, count, [&] {
+    int64_t total = 0;
+    for (const stdx::string& token : int_tokens) { total += std::strtoll(token.c_str(), nullptr, 10); }
+    do_not_optimize(total);
+  });
+  std::vector<int64_t> column;
+  run(opts, "convert/int64/stdx_column", int_bytes, count, [&] {
+    column.clear();
+    stdx::convert_column(int_tokens.begin(), int_tokens.end(), column);
+    do_not_optimize(column.data());
+  });
+  run(opts, "convert/double/stdx_convert", real_bytes, count, [&] {
+    double total = 0;
+    for (const stdx::string& token : real_tokens) { total += token.convert<double>(); }
+    do_not_optimize(total);
+  });
+  run(opts, "convert/double/std_strtod", real_bytes, count, [&] {
+    double total = 0;
+    for (const stdx::string& token : real_tokens) { total += std::strtod(token.c_str(), nullptr); }
+    do_not_optimize(total);
+  });
+}
+
+void bench_fixed_vector(const options& opts) {
+  const int64_t min = -500000, max = 499999;
+  stdx::fixed_vector<int64_t> fixed(min, max, 1);
+  std::vector<int64_t> plain(static_cast<std::size_t>(max - min + 1), 1);
+  const double count = static_cast<double>(plain.size());
+  const double bytes = count * sizeof(int64_t);
+  run(opts, "fixed_vector/operator[]", bytes, count, [&] {
+    int64_t total = 0;
+    for (int64_t i = min; i <= max; ++i) { total += fixed[i]; }
+    do_not_optimize(total);
+  });
+  run(opts, "fixed_vector/at", bytes, count, [&] {
+    int64_t total = 0;
+    for (int64_t i = min; i <= max; ++i) { total += fixed.at(i); }
+    do_not_optimize(total);
+  });
+  run(opts, "std_vector/operator[]", bytes, count, [&] {
+    int64_t total = 0;
+    for (std::size_t i = 0; i < plain.size(); ++i) { total += plain[i]; }
+    do_not_optimize(total);
+  });
+  run(opts, "std_vector/at", bytes, count, [&] {
+    int64_t total = 0;
+    for (std::size_t i = 0; i < plain.size(); ++i) { total += plain.at(i); }
+    do_not_optimize(total);
+  });
+}
+
+void bench_soa(const options& opts) {
+  // Particle records, of which a pass updates only the positions from the velocities
+  struct particle { double x, y, z, vx, vy, vz; int64_t id, cell; };
+  const int64_t min = -100000, max = 99999;
+  stdx::fixed_vector<particle> aos(min, max, particle{0, 0, 0, 1, 2, 3, 0, 0});
+  stdx::fixed_soa_vector<double, double, double, double, double, double, int64_t, int64_t> soa(min, max, {0, 0, 0, 1, 2, 3, 0, 0});
+  const double count = static_cast<double>(aos.size());
+  const double dt = 0.001;
+  run(opts, "soa/update_x/fixed_vector_of_structs", count * sizeof(particle), count, [&] {
+    for (int64_t i = min; i <= max; ++i) { aos[i].x += aos[i].vx * dt; }
+    do_not_optimize(aos.data());
+  });
+  run(opts, "soa/update_x/fixed_soa_vector", count * 2 * sizeof(double), count, [&] {
+    double* x = soa.data<0>();
+    const double* vx = soa.data<3>();
+    for (std::size_t i = 0; i < soa.size(); ++i) { x[i] += vx[i] * dt; }
+    do_not_optimize(x);
+  });
+  run(opts, "soa/update_x/fixed_soa_vector_field_view", count * 2 * sizeof(double), count, [&] {
+    auto x = soa.field<0>();
+    const auto vx = soa.field<3>();
+    for (int64_t i = min; i <= max; ++i) { x[i] += vx[i] * dt; }
+    do_not_optimize(x.data());
+  });
+}
+
+void bench_mapped(const options& opts) {
+  // Startup cost of a lookup table with negative indices: parse text, or map a saved table
+  const int64_t min = -500000, max = 499999;
+  stdx::fixed_vector<int64_t> table(min, max, 0);
+  for (int64_t i = min; i <= max; ++i) { table[i] = i * 7919 % 1000003; }
+  const std::string text_path = "stdx_bench_table.txt", binary_path = "stdx_bench_table.bin";
+  {
+    std::FILE* out = std::fopen(text_path.c_str(), "w");
+    for (int64_t i = min; i <= max; ++i) { std::fprintf(out, "%lld\n", static_cast<long long>(table[i])); }
+    std::fclose(out);
+  }
+  stdx::save(table, binary_path);
+  const double count = static_cast<double>(table.size());
+  const double bytes = count * sizeof(int64_t);
+  run(opts, "mapped/load_table/parse_text", bytes, count, [&] {
+    const stdx::mapped_file file(text_path);
+    stdx::fixed_vector<int64_t> loaded(min, max, 0);
+    const char* p = file.data();
+    const char* end = p + file.size();
+    for (int64_t i = min; i <= max; ++i) {
+      p = std::from_chars(p, end, loaded[i]).ptr + 1;
+    }
+    do_not_optimize(loaded[max]);
+  });
+  run(opts, "mapped/load_table/mapped_fixed_vector", bytes, count, [&] {
+    const stdx::mapped_fixed_vector<int64_t> loaded(binary_path);
+    do_not_optimize(loaded[max]);
+  });
+  run(opts, "mapped/load_table/mapped_fixed_vector_verified", bytes, count, [&] {
+    const stdx::mapped_fixed_vector<int64_t> loaded(binary_path, true);
+    do_not_optimize(loaded[max]);
+  });
+  std::remove(text_path.c_str());
+  std::remove(binary_path.c_str());
+}
+
+void bench_parallel(const options& opts) {
+  const int64_t min = -2000000, max = 1999999;
+  stdx::fixed_vector<double> in(min, max, 1.0), out(min, max, 0.0);
+  const double count = static_cast<double>(in.size());
+  const double bytes = count * sizeof(double);
+  auto physics = [](int64_t i, double x) { return x * 0.5 + static_cast<double>(i) * 1e-3; };
+  run(opts, "parallel/transform/serial", bytes, count, [&] {
+    for (int64_t i = min; i <= max; ++i) { out[i] = physics(i, in[i]); }
+    do_not_optimize(out.data());
+  });
+  run(opts, "parallel/transform/transform_indexed", bytes, count, [&] {
+    stdx::transform_indexed(in, out, physics);
+    do_not_optimize(out.data());
+  });
+  run(opts, "parallel/reduce/serial", bytes, count, [&] {
+    double total = 0;
+    for (int64_t i = min; i <= max; ++i) { total += physics(i, in[i]); }
+    do_not_optimize(total);
+  });
+  run(opts, "parallel/reduce/reduce_indexed", bytes, count, [&] {
+    double total = stdx::reduce_indexed(in, 0.0, std::plus<>(), physics);
+    do_not_optimize(total);
+  });
+}
+
+void bench_histogram(const options& opts) {
+  const int64_t min = -512, max = 511;
+  const int threads = 4, per_thread = 250000;
+  const double count = static_cast<double>(threads) * per_thread;
+  auto contend = [&](auto&& add) {
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+      workers.emplace_back([&, t] {
+        uint64_t x = static_cast<uint64_t>(t) * 0x9e3779b97f4a7c15ull + 1;
+        for (int i = 0; i < per_thread; ++i) {
+          x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+          add(min + static_cast<int64_t>(x % static_cast<uint64_t>(max - min + 1)));
+        }
+      });
+    }
+    for (std::thread& worker : workers) { worker.join(); }
+  };
+  stdx::fixed_vector<int64_t> locked(min, max, int64_t(0));
+  std::mutex mutex;
+  run(opts, "histogram/mutex_fixed_vector", 0, count, [&] {
+    contend([&](int64_t i) { std::lock_guard<std::mutex> lock(mutex); ++locked[i]; });
+  });
+  stdx::concurrent_fixed_histogram<int64_t> sharded(min, max, threads);
+  run(opts, "histogram/concurrent_sharded", 0, count, [&] {
+    contend([&](int64_t i) { sharded.add(i); });
+    do_not_optimize(sharded[0]);
+  });
+  stdx::concurrent_fixed_histogram<int64_t> shared(min, max, 1);
+  run(opts, "histogram/concurrent_single_shard", 0, count, [&] {
+    contend([&](int64_t i) { shared.add(i); });
+    do_not_optimize(shared[0]);
+  });
+}
+
+}
+
+int main(int argc, const char* argv[]) {
+  options opts;
+  for (int i = 1; i < argc; ++i) {
+    if (std::strcmp(argv[i], "--filter") == 0 && i + 1 < argc) { opts.filter = argv[++i]; }
+    else if (std::strcmp(argv[i], "--min-time") == 0 && i + 1 < argc) { opts.min_time = std::atof(argv[++i]); }
+    else {
+      std::fprintf(stderr, "Usage: %s [--filter <substring>] [--min-time <seconds>]\n", argv[0]);
+      return 1;
+    }
+  }
+
+  const std::vector<corpus> corpora = {
+    make_corpus("short_tokens", 2000, 8, 1, 4, 0, ' '),
+    make_corpus("long_lines", 200, 200, 8, 20, 0, ' '),
+    make_corpus("mostly_whitespace", 2000, 4, 1, 6, 24, ' '),
+  };
+  const std::vector<corpus> csv = {
+    make_corpus("short_tokens_csv", 2000, 8, 0, 4, 0, ','),
+    make_corpus("long_lines_csv", 200, 200, 8, 20, 0, ','),
+  };
+
+  std::printf("%-44s %15s %17s %20s %19s\n", "benchmark", "time/iter", "bytes", "elements", "allocs/iter");
+  bench_split_whitespace(opts, corpora);
+  bench_split_keep_empty(opts, csv);
+  bench_strip(opts, corpora);
+  bench_join(opts, corpora);
+  bench_replace(opts);
+  bench_case(opts);
+  bench_intern(opts);
+  bench_utf(opts);
+  bench_convert(opts);
+  bench_fixed_vector(opts);
+  bench_soa(opts);
+  bench_mapped(opts);
+  bench_parallel(opts);
+  bench_histogram(opts);
+  return 0;
+}
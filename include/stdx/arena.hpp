@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+
+namespace stdx {
+namespace pmr {
+
+/** Monotonic arena for allocating many short-lived objects, such as all the tokens produced while handling one request.
+
+ Allocations are served from an inline buffer of InlineSize bytes, then from progressively larger blocks obtained from the upstream resource. Deallocation does nothing; all memory is freed at once by release, or when the arena is destroyed. Use with the stdx::pmr container and string aliases, whose operations propagate the arena's allocator to the strings they produce.
+
+ An arena is not thread safe, so use one per thread or per request.
+
+ \tparam InlineSize size in bytes of the buffer held inside the arena itself.
+ */
+template <std::size_t InlineSize = 4096>
+class arena {
+  static_assert(InlineSize > 0, "The inline buffer of an arena must not be empty");
+public:
+  /* Constructors */
+  /** Construct an arena obtaining additional blocks from \p upstream. */
+  explicit arena(std::pmr::memory_resource* upstream = std::pmr::get_default_resource()) noexcept
+  : buffer(), monotonic(buffer, InlineSize, upstream) { }
+
+  arena(const arena&) = delete;
+  arena& operator=(const arena&) = delete;
+
+  /** Returns the memory resource allocating from the arena. */
+  std::pmr::memory_resource* resource() noexcept { return &monotonic; }
+  /** Returns an allocator allocating from the arena. */
+  template <class T = std::byte>
+  std::pmr::polymorphic_allocator<T> allocator() noexcept { return std::pmr::polymorphic_allocator<T>(&monotonic); }
+
+  /** Free all memory allocated from the arena. Every object allocated from the arena must have been destroyed, or must never be used again. */
+  void release() { monotonic.release(); }
+
+private:
+  alignas(std::max_align_t) std::byte buffer[InlineSize];
+  std::pmr::monotonic_buffer_resource monotonic;
+};
+
+}
+}
@@ -0,0 +1,189 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include "char_class.hpp"
+#include "common.hpp"
+
+namespace stdx {
+
+namespace detail {
+
+enum class ascii_case { lower, upper, swap };
+
+/** Convert the case of \p c if it is an ASCII letter. All other code units are returned unchanged, so the conversion does not depend on the locale. */
+template <ascii_case Case, class CharT>
+constexpr CharT ascii_convert(CharT c) noexcept {
+  using unsigned_type = std::make_unsigned_t<CharT>;
+  const unsigned_type u = static_cast<unsigned_type>(c);
+  const bool is_upper = static_cast<unsigned_type>(u - unsigned_type('A')) < 26u;
+  const bool is_lower = static_cast<unsigned_type>(u - unsigned_type('a')) < 26u;
+  if (Case == ascii_case::lower) { return is_upper ? static_cast<CharT>(u | 0x20u) : c; }
+  if (Case == ascii_case::upper) { return is_lower ? static_cast<CharT>(u ^ 0x20u) : c; }
+  return (is_upper || is_lower) ? static_cast<CharT>(u ^ 0x20u) : c;
+}
+
+/* Scalar kernels. dst may equal src. */
+template <ascii_case Case, class CharT>
+inline void ascii_convert_scalar(CharT* dst, const CharT* src, std::size_t n) noexcept {
+  for (std::size_t i = 0; i < n; ++i) { dst[i] = ascii_convert<Case>(src[i]); }
+}
+template <class CharT>
+inline bool ascii_iequal_scalar(const CharT* a, const CharT* b, std::size_t n) noexcept {
+  for (std::size_t i = 0; i < n; ++i) {
+    if (ascii_convert<ascii_case::lower>(a[i]) != ascii_convert<ascii_case::lower>(b[i])) { return false; }
+  }
+  return true;
+}
+
+/** Lower case the ASCII letters in the 8 bytes of \p w, leaving all other bytes unchanged. */
+constexpr std::uint64_t swar_ascii_lower(std::uint64_t w) noexcept {
+  constexpr std::uint64_t ones = 0x0101010101010101ull, high = ones * 0x80;
+  const std::uint64_t heptets = w & ~high;
+  const std::uint64_t at_least_a = heptets + ones * (0x80 - 'A');      // High bit set in bytes >= 'A'
+  const std::uint64_t above_z = heptets + ones * (0x80 - 'Z' - 1);     // High bit set in bytes > 'Z'
+  const std::uint64_t upper = at_least_a & ~above_z & ~w & high;       // High bit set in bytes 'A' to 'Z'
+  return w | (upper >> 2);
+}
+
+#ifdef STDX_X86_SIMD
+/* SSE2 and AVX2 kernels. Letters are found with one add and one signed compare per range, which moves the range to the bottom of the signed byte range. */
+template <ascii_case Case>
+inline __m128i ascii_convert_sse2(__m128i v) noexcept {
+  const __m128i limit = _mm_set1_epi8(static_cast<char>(-128 + 26)), flip = _mm_set1_epi8(0x20);
+  const __m128i is_upper = _mm_cmplt_epi8(_mm_add_epi8(v, _mm_set1_epi8(static_cast<char>(128 - 'A'))), limit);
+  const __m128i is_lower = _mm_cmplt_epi8(_mm_add_epi8(v, _mm_set1_epi8(static_cast<char>(128 - 'a'))), limit);
+  const __m128i letters = Case == ascii_case::lower ? is_upper : Case == ascii_case::upper ? is_lower : _mm_or_si128(is_upper, is_lower);
+  return _mm_xor_si128(v, _mm_and_si128(letters, flip));
+}
+template <ascii_case Case>
+inline void ascii_convert_sse2(unsigned char* dst, const unsigned char* src, std::size_t n) noexcept {
+  std::size_t i = 0;
+  for (; i + 16 <= n; i += 16) {
+    const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), ascii_convert_sse2<Case>(v));
+  }
+  ascii_convert_scalar<Case>(dst + i, src + i, n - i);
+}
+inline bool ascii_iequal_sse2(const unsigned char* a, const unsigned char* b, std::size_t n) noexcept {
+  std::size_t i = 0;
+  for (; i + 16 <= n; i += 16) {
+    const __m128i x = ascii_convert_sse2<ascii_case::lower>(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i)));
+    const __m128i y = ascii_convert_sse2<ascii_case::lower>(_mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i)));
+    if (_mm_movemask_epi8(_mm_cmpeq_epi8(x, y)) != 0xffff) { return false; }
+  }
+  return ascii_iequal_scalar(a + i, b + i, n - i);
+}
+
+template <ascii_case Case>
+__attribute__((target("avx2")))
+inline __m256i ascii_convert_avx2(__m256i v) noexcept {
+  const __m256i limit = _mm256_set1_epi8(static_cast<char>(-128 + 26)), flip = _mm256_set1_epi8(0x20);
+  const __m256i is_upper = _mm256_cmpgt_epi8(limit, _mm256_add_epi8(v, _mm256_set1_epi8(static_cast<char>(128 - 'A'))));
+  const __m256i is_lower = _mm256_cmpgt_epi8(limit, _mm256_add_epi8(v, _mm256_set1_epi8(static_cast<char>(128 - 'a'))));
+  const __m256i letters = Case == ascii_case::lower ? is_upper : Case == ascii_case::upper ? is_lower : _mm256_or_si256(is_upper, is_lower);
+  return _mm256_xor_si256(v, _mm256_and_si256(letters, flip));
+}
+template <ascii_case Case>
+__attribute__((target("avx2")))
+inline void ascii_convert_avx2(unsigned char* dst, const unsigned char* src, std::size_t n) noexcept {
+  std::size_t i = 0;
+  for (; i + 32 <= n; i += 32) {
+    const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), ascii_convert_avx2<Case>(v));
+  }
+  ascii_convert_scalar<Case>(dst + i, src + i, n - i);
+}
+__attribute__((target("avx2")))
+inline bool ascii_iequal_avx2(const unsigned char* a, const unsigned char* b, std::size_t n) noexcept {
+  std::size_t i = 0;
+  for (; i + 32 <= n; i += 32) {
+    const __m256i x = ascii_convert_avx2<ascii_case::lower>(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i)));
+    const __m256i y = ascii_convert_avx2<ascii_case::lower>(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i)));
+    if (static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(x, y))) != 0xffffffffu) { return false; }
+  }
+  return ascii_iequal_scalar(a + i, b + i, n - i);
+}
+#endif
+
+/* Dispatchers. Pick the widest kernel available for the length of the input, and use scalar code for wide character types. */
+template <ascii_case Case, class CharT>
+inline void ascii_convert(CharT* dst, const CharT* src, std::size_t n) noexcept {
+#ifdef STDX_X86_SIMD
+  if constexpr (sizeof(CharT) == 1) {
+    unsigned char* d = reinterpret_cast<unsigned char*>(dst);
+    const unsigned char* s = reinterpret_cast<const unsigned char*>(src);
+    if (n >= 32 && cpu_has_avx2()) { ascii_convert_avx2<Case>(d, s, n); return; }
+    if (n >= 16) { ascii_convert_sse2<Case>(d, s, n); return; }
+  }
+#endif
+  ascii_convert_scalar<Case>(dst, src, n);
+}
+template <class CharT>
+inline bool ascii_iequal(const CharT* a, const CharT* b, std::size_t n) noexcept {
+#ifdef STDX_X86_SIMD
+  if constexpr (sizeof(CharT) == 1) {
+    const unsigned char* x = reinterpret_cast<const unsigned char*>(a);
+    const unsigned char* y = reinterpret_cast<const unsigned char*>(b);
+    if (n >= 32 && cpu_has_avx2()) { return ascii_iequal_avx2(x, y, n); }
+    if (n >= 16) { return ascii_iequal_sse2(x, y, n); }
+  }
+#endif
+  return ascii_iequal_scalar(a, b, n);
+}
+
+/** Hash of the characters [\p s, \p s + \p n) with ASCII letters lower cased. Single byte character types are hashed 8 bytes at a time. */
+template <class CharT>
+inline std::size_t ascii_ihash(const CharT* s, std::size_t n) noexcept {
+  if constexpr (sizeof(CharT) == 1) {
+    return static_cast<std::size_t>(hash_bytes(s, n, swar_ascii_lower));
+  } else {
+    word_hash hash(n);
+    for (std::size_t i = 0; i < n; ++i) { hash.mix(static_cast<std::uint64_t>(ascii_convert<ascii_case::lower>(s[i]))); }
+    return static_cast<std::size_t>(hash.value());
+  }
+}
+
+}
+
+/** Returns true if \p a and \p b are equal, ignoring the case of ASCII letters.
+ *  Comparison does not depend on the locale. Other characters, including non-ASCII letters, must match exactly.
+ */
+template <class CharT, class Traits>
+bool iequals(std::basic_string_view<CharT, Traits> a, std::basic_string_view<CharT, Traits> b) noexcept {
+  return a.size() == b.size() && detail::ascii_iequal(a.data(), b.data(), a.size());
+}
+inline bool iequals(std::string_view a, std::string_view b) noexcept { return iequals<char, std::char_traits<char>>(a, b); }
+
+/** Hash functor ignoring the case of ASCII letters, consistent with iequals.
+ *  Use with basic_iequal_to as the hash and key equality of unordered containers, to look up keys in any case without creating a normalised copy.
+ */
+template <class CharT, class Traits = std::char_traits<CharT>>
+struct basic_ihash {
+  using is_transparent = void;
+  std::size_t operator()(std::basic_string_view<CharT, Traits> str) const noexcept { return detail::ascii_ihash(str.data(), str.size()); }
+};
+
+/** Equality functor ignoring the case of ASCII letters. See iequals. */
+template <class CharT, class Traits = std::char_traits<CharT>>
+struct basic_iequal_to {
+  using is_transparent = void;
+  bool operator()(std::basic_string_view<CharT, Traits> a, std::basic_string_view<CharT, Traits> b) const noexcept { return iequals(a, b); }
+};
+
+/** Typedefs for common character types **/
+using ihash = basic_ihash<char>;
+using wihash = basic_ihash<wchar_t>;
+using u16ihash = basic_ihash<char16_t>;
+using u32ihash = basic_ihash<char32_t>;
+
+using iequal_to = basic_iequal_to<char>;
+using wiequal_to = basic_iequal_to<wchar_t>;
+using u16iequal_to = basic_iequal_to<char16_t>;
+using u32iequal_to = basic_iequal_to<char32_t>;
+
+}
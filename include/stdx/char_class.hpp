@@ -0,0 +1,329 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define STDX_X86_SIMD 1
+#include <immintrin.h>
+#endif
+
+namespace stdx {
+
+namespace detail {
+
+/** Membership tables for a set of byte values.
+ *  Holds a 256-bit bitmap for scalar lookups, nibble tables for the shuffle-based AVX2 kernel, and a short list of the members for the compare-based SSE2 kernel.
+ */
+struct byte_set {
+  static constexpr unsigned max_small = 8;
+
+  std::uint64_t bits[4];
+  std::uint8_t nibble_low[16];   // Bit h of entry l set if (h << 4 | l) is a member, for h in [0, 8)
+  std::uint8_t nibble_high[16];  // Bit h of entry l set if ((h + 8) << 4 | l) is a member, for h in [0, 8)
+  std::uint8_t small[max_small];
+  std::uint8_t small_count;      // Number of distinct members, saturating at max_small + 1
+
+  constexpr bool contains(std::uint8_t c) const noexcept { return (bits[c >> 6] >> (c & 63)) & 1u; }
+
+  constexpr void insert(std::uint8_t c) noexcept {
+    if (contains(c)) { return; }
+    bits[c >> 6] |= std::uint64_t(1) << (c & 63);
+    const unsigned lo = c & 0x0f, hi = c >> 4;
+    if (hi < 8) { nibble_low[lo] |= static_cast<std::uint8_t>(1u << hi); }
+    else { nibble_high[lo] |= static_cast<std::uint8_t>(1u << (hi - 8)); }
+    if (small_count < max_small) { small[small_count] = c; }
+    if (small_count <= max_small) { ++small_count; }
+  }
+};
+
+constexpr std::size_t scan_npos = static_cast<std::size_t>(-1);
+
+/* Scalar kernels. Return the index of the first (last) byte whose membership equals Member, or scan_npos. */
+template <bool Member>
+inline std::size_t find_first_scalar(const unsigned char* s, std::size_t n, const byte_set& set) noexcept {
+  for (std::size_t i = 0; i < n; ++i) { if (set.contains(s[i]) == Member) { return i; } }
+  return scan_npos;
+}
+template <bool Member>
+inline std::size_t find_last_scalar(const unsigned char* s, std::size_t n, const byte_set& set) noexcept {
+  for (std::size_t i = n; i-- > 0;) { if (set.contains(s[i]) == Member) { return i; } }
+  return scan_npos;
+}
+
+#ifdef STDX_X86_SIMD
+/** Returns true if the executing CPU supports AVX2. Evaluated once. */
+inline bool cpu_has_avx2() noexcept {
+  static const bool supported = [] { __builtin_cpu_init(); return __builtin_cpu_supports("avx2") != 0; }();
+  return supported;
+}
+
+/* SSE2 kernels. Compare each 16 byte block against every member, so only used for sets with at most max_small members. */
+inline unsigned sse2_member_mask(__m128i block, const __m128i* needles, unsigned count) noexcept {
+  __m128i eq = _mm_setzero_si128();
+  for (unsigned k = 0; k < count; ++k) { eq = _mm_or_si128(eq, _mm_cmpeq_epi8(block, needles[k])); }
+  return static_cast<unsigned>(_mm_movemask_epi8(eq));
+}
+template <bool Member>
+inline std::size_t find_first_sse2(const unsigned char* s, std::size_t n, const byte_set& set) noexcept {
+  __m128i needles[byte_set::max_small];
+  for (unsigned k = 0; k < set.small_count; ++k) { needles[k] = _mm_set1_epi8(static_cast<char>(set.small[k])); }
+  std::size_t i = 0;
+  for (; i + 16 <= n; i += 16) {
+    unsigned mask = sse2_member_mask(_mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i)), needles, set.small_count);
+    if (!Member) { mask = ~mask & 0xffffu; }
+    if (mask) { return i + static_cast<std::size_t>(__builtin_ctz(mask)); }
+  }
+  std::size_t tail = find_first_scalar<Member>(s + i, n - i, set);
+  return tail == scan_npos ? scan_npos : i + tail;
+}
+template <bool Member>
+inline std::size_t find_last_sse2(const unsigned char* s, std::size_t n, const byte_set& set) noexcept {
+  __m128i needles[byte_set::max_small];
+  for (unsigned k = 0; k < set.small_count; ++k) { needles[k] = _mm_set1_epi8(static_cast<char>(set.small[k])); }
+  while (n >= 16) {
+    n -= 16;
+    unsigned mask = sse2_member_mask(_mm_loadu_si128(reinterpret_cast<const __m128i*>(s + n)), needles, set.small_count);
+    if (!Member) { mask = ~mask & 0xffffu; }
+    if (mask) { return n + static_cast<std::size_t>(31 - __builtin_clz(mask)); }
+  }
+  return find_last_scalar<Member>(s, n, set);
+}
+
+/* AVX2 kernels. Look up membership of all 32 bytes of a block with two nibble-indexed shuffles, so work for any set. */
+__attribute__((target("avx2")))
+inline std::uint32_t avx2_member_mask(__m256i block, __m256i low_table, __m256i high_table, __m256i bit_table) noexcept {
+  const __m256i nibble = _mm256_set1_epi8(0x0f);
+  const __m256i lo = _mm256_and_si256(block, nibble);
+  const __m256i hi = _mm256_and_si256(_mm256_srli_epi16(block, 4), nibble);
+  const __m256i row = _mm256_blendv_epi8(_mm256_shuffle_epi8(low_table, lo), _mm256_shuffle_epi8(high_table, lo),
+                                         _mm256_cmpgt_epi8(hi, _mm256_set1_epi8(7)));
+  const __m256i absent = _mm256_cmpeq_epi8(_mm256_and_si256(row, _mm256_shuffle_epi8(bit_table, hi)), _mm256_setzero_si256());
+  return ~static_cast<std::uint32_t>(_mm256_movemask_epi8(absent));
+}
+#define STDX_AVX2_TABLES(set) \
+  const __m256i low_table = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>((set).nibble_low))); \
+  const __m256i high_table = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>((set).nibble_high))); \
+  const __m256i bit_table = _mm256_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128, \
+                                             1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128)
+template <bool Member>
+__attribute__((target("avx2")))
+inline std::size_t find_first_avx2(const unsigned char* s, std::size_t n, const byte_set& set) noexcept {
+  STDX_AVX2_TABLES(set);
+  std::size_t i = 0;
+  for (; i + 32 <= n; i += 32) {
+    std::uint32_t mask = avx2_member_mask(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + i)), low_table, high_table, bit_table);
+    if (!Member) { mask = ~mask; }
+    if (mask) { return i + static_cast<std::size_t>(__builtin_ctz(mask)); }
+  }
+  std::size_t tail = find_first_scalar<Member>(s + i, n - i, set);
+  return tail == scan_npos ? scan_npos : i + tail;
+}
+template <bool Member>
+__attribute__((target("avx2")))
+inline std::size_t find_last_avx2(const unsigned char* s, std::size_t n, const byte_set& set) noexcept {
+  STDX_AVX2_TABLES(set);
+  while (n >= 32) {
+    n -= 32;
+    std::uint32_t mask = avx2_member_mask(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + n)), low_table, high_table, bit_table);
+    if (!Member) { mask = ~mask; }
+    if (mask) { return n + static_cast<std::size_t>(31 - __builtin_clz(mask)); }
+  }
+  return find_last_scalar<Member>(s, n, set);
+}
+#undef STDX_AVX2_TABLES
+#endif
+
+/* Dispatchers. Pick the widest kernel available for the length of the input. */
+template <bool Member>
+inline std::size_t find_first(const unsigned char* s, std::size_t n, const byte_set& set) noexcept {
+#ifdef STDX_X86_SIMD
+  if (n >= 32 && cpu_has_avx2()) { return find_first_avx2<Member>(s, n, set); }
+  if (n >= 16 && set.small_count <= byte_set::max_small) { return find_first_sse2<Member>(s, n, set); }
+#endif
+  return find_first_scalar<Member>(s, n, set);
+}
+template <bool Member>
+inline std::size_t find_last(const unsigned char* s, std::size_t n, const byte_set& set) noexcept {
+#ifdef STDX_X86_SIMD
+  if (n >= 32 && cpu_has_avx2()) { return find_last_avx2<Member>(s, n, set); }
+  if (n >= 16 && set.small_count <= byte_set::max_small) { return find_last_sse2<Member>(s, n, set); }
+#endif
+  return find_last_scalar<Member>(s, n, set);
+}
+
+}
+
+/** Precompiled set of characters, used for fast stripping and splitting.
+
+ Code units below 256 are held in a bitmap, and for single byte character types searches use SSE2 or AVX2 kernels, selected at runtime. Wider character types can additionally hold up to max_extended code units of 256 or above, which are searched linearly.
+
+ Construction is constexpr, so sets can be built at compile time. Commonly used sets are available from char_classes.
+
+ \tparam CharT character type.
+ */
+template <class CharT>
+class basic_char_class {
+  using unsigned_type = std::make_unsigned_t<CharT>;
+
+public:
+  /* Member types */
+  using value_type = CharT;
+  using size_type = std::size_t;
+
+  /* Static constants */
+  static constexpr size_type npos = static_cast<size_type>(-1);
+  /** Maximum number of code units of 256 or above that may be held. Always zero for single byte character types. */
+  static constexpr size_type max_extended = sizeof(CharT) == 1 ? 0 : 32;
+
+  /* Constructors */
+  /** Default constructor.
+   *  Constructs an empty set.
+   */
+  constexpr basic_char_class() noexcept : bytes{}, extended{}, extended_count(0) { }
+  /** Construct the set from the \p count characters pointed to by \p s, which may contain null characters. */
+  constexpr basic_char_class(const CharT* s, size_type count) : basic_char_class() {
+    for (size_type i = 0; i < count; ++i) { insert(s[i]); }
+  }
+  /** Construct the set from the null-terminated character string pointed to by \p s. */
+  constexpr explicit basic_char_class(const CharT* s) : basic_char_class() {
+    for (; *s != CharT(); ++s) { insert(*s); }
+  }
+  /** Construct the set from the characters of \p chars. */
+  template <class Traits>
+  constexpr explicit basic_char_class(std::basic_string_view<CharT, Traits> chars)
+  : basic_char_class(chars.data(), chars.size()) { }
+  template <class Traits, class Allocator>
+  explicit basic_char_class(const std::basic_string<CharT, Traits, Allocator>& chars)
+  : basic_char_class(chars.data(), chars.size()) { }
+
+  /** Add \p c to the set. If \p c does not fit in the bitmap and max_extended such characters are already held, an exception of type std::length_error is thrown. */
+  constexpr basic_char_class& insert(CharT c) {
+    const unsigned_type u = static_cast<unsigned_type>(c);
+    if (u < 256) { bytes.insert(static_cast<std::uint8_t>(u)); return *this; }
+    if (contains(c)) { return *this; }
+    if (extended_count == max_extended) { throw std::length_error("basic_char_class::insert"); }
+    extended[extended_count++] = u;
+    return *this;
+  }
+
+  /** Returns the union of this and \p other. */
+  constexpr basic_char_class operator|(const basic_char_class& other) const {
+    basic_char_class result(*this);
+    for (unsigned i = 0; i < 256; ++i) {
+      if (other.bytes.contains(static_cast<std::uint8_t>(i))) { result.bytes.insert(static_cast<std::uint8_t>(i)); }
+    }
+    for (size_type i = 0; i < other.extended_count; ++i) { result.insert(static_cast<CharT>(other.extended[i])); }
+    return result;
+  }
+
+  /** Returns true if \p c is in the set. */
+  constexpr bool contains(CharT c) const noexcept {
+    const unsigned_type u = static_cast<unsigned_type>(c);
+    if (u < 256) { return bytes.contains(static_cast<std::uint8_t>(u)); }
+    for (size_type i = 0; i < extended_count; ++i) { if (extended[i] == u) { return true; } }
+    return false;
+  }
+
+  /** Find the first character of [\p s + \p pos, \p s + \p count) that is in the set. Returns its index, or npos if there is none. */
+  size_type find_first_of(const CharT* s, size_type count, size_type pos = 0) const noexcept { return find_first<true>(s, count, pos); }
+  /** Find the first character of [\p s + \p pos, \p s + \p count) that is not in the set. Returns its index, or npos if there is none. */
+  size_type find_first_not_of(const CharT* s, size_type count, size_type pos = 0) const noexcept { return find_first<false>(s, count, pos); }
+  /** Find the last character of [\p s, \p s + min(\p pos + 1, \p count)) that is in the set. Returns its index, or npos if there is none. */
+  size_type find_last_of(const CharT* s, size_type count, size_type pos = npos) const noexcept { return find_last<true>(s, count, pos); }
+  /** Find the last character of [\p s, \p s + min(\p pos + 1, \p count)) that is not in the set. Returns its index, or npos if there is none. */
+  size_type find_last_not_of(const CharT* s, size_type count, size_type pos = npos) const noexcept { return find_last<false>(s, count, pos); }
+
+  template <class Traits>
+  size_type find_first_of(std::basic_string_view<CharT, Traits> str, size_type pos = 0) const noexcept { return find_first<true>(str.data(), str.size(), pos); }
+  template <class Traits>
+  size_type find_first_not_of(std::basic_string_view<CharT, Traits> str, size_type pos = 0) const noexcept { return find_first<false>(str.data(), str.size(), pos); }
+  template <class Traits>
+  size_type find_last_of(std::basic_string_view<CharT, Traits> str, size_type pos = npos) const noexcept { return find_last<true>(str.data(), str.size(), pos); }
+  template <class Traits>
+  size_type find_last_not_of(std::basic_string_view<CharT, Traits> str, size_type pos = npos) const noexcept { return find_last<false>(str.data(), str.size(), pos); }
+
+private:
+  template <bool Member>
+  size_type find_first(const CharT* s, size_type count, size_type pos) const noexcept {
+    if (pos >= count) { return npos; }
+    if constexpr (sizeof(CharT) == 1) {
+      size_type found = detail::find_first<Member>(reinterpret_cast<const unsigned char*>(s) + pos, count - pos, bytes);
+      return found == npos ? npos : pos + found;
+    } else {
+      for (size_type i = pos; i < count; ++i) { if (contains(s[i]) == Member) { return i; } }
+      return npos;
+    }
+  }
+  template <bool Member>
+  size_type find_last(const CharT* s, size_type count, size_type pos) const noexcept {
+    if (pos < count) { count = pos + 1; }
+    if constexpr (sizeof(CharT) == 1) {
+      return detail::find_last<Member>(reinterpret_cast<const unsigned char*>(s), count, bytes);
+    } else {
+      for (size_type i = count; i-- > 0;) { if (contains(s[i]) == Member) { return i; } }
+      return npos;
+    }
+  }
+
+  detail::byte_set bytes;
+  unsigned_type extended[max_extended == 0 ? 1 : max_extended];
+  size_type extended_count;
+};
+
+namespace detail {
+
+/** Code points with the Unicode White_Space property. */
+constexpr char32_t unicode_whitespace_points[] = {0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x20, 0x85, 0xa0, 0x1680,
+                                                  0x2000, 0x2001, 0x2002, 0x2003, 0x2004, 0x2005, 0x2006, 0x2007, 0x2008, 0x2009, 0x200a,
+                                                  0x2028, 0x2029, 0x202f, 0x205f, 0x3000};
+
+/** Class of the Unicode whitespace code points which are a single code unit of CharT. For single byte types, which hold UTF-8, that is only the ASCII members. */
+template <class CharT>
+constexpr basic_char_class<CharT> make_unicode_whitespace() {
+  basic_char_class<CharT> result;
+  for (char32_t cp : unicode_whitespace_points) {
+    if (sizeof(CharT) > 1 || cp < 0x80) { result.insert(static_cast<CharT>(cp)); }
+  }
+  return result;
+}
+
+}
+
+/** Commonly used character classes.
+ *  Each is a constant initialised at compile time, so can be passed by reference without any construction cost.
+ */
+template <class CharT>
+struct char_classes {
+  static constexpr CharT whitespace_chars[] = {0x20, 0x0c, 0x0a, 0x0d, 0x09, 0x0b, 0x0};
+  static constexpr CharT lowercase_chars[] = {'a', 'b', 'c', 'd', 'e', 'f', 'g', 'h', 'i', 'j', 'k', 'l', 'm',
+                                              'n', 'o', 'p', 'q', 'r', 's', 't', 'u', 'v', 'w', 'x', 'y', 'z'};
+  static constexpr CharT uppercase_chars[] = {'A', 'B', 'C', 'D', 'E', 'F', 'G', 'H', 'I', 'J', 'K', 'L', 'M',
+                                              'N', 'O', 'P', 'Q', 'R', 'S', 'T', 'U', 'V', 'W', 'X', 'Y', 'Z'};
+  static constexpr CharT digit_chars[] = {'0', '1', '2', '3', '4', '5', '6', '7', '8', '9'};
+  static constexpr CharT hexdigit_chars[] = {'0', '1', '2', '3', '4', '5', '6', '7', '8', '9',
+                                             'A', 'B', 'C', 'D', 'E', 'F', 'a', 'b', 'c', 'd', 'e', 'f'};
+
+  static constexpr basic_char_class<CharT> whitespace{whitespace_chars, std::size(whitespace_chars)};
+  static constexpr basic_char_class<CharT> lowercase{lowercase_chars, std::size(lowercase_chars)};
+  static constexpr basic_char_class<CharT> uppercase{uppercase_chars, std::size(uppercase_chars)};
+  static constexpr basic_char_class<CharT> digits{digit_chars, std::size(digit_chars)};
+  static constexpr basic_char_class<CharT> hexdigits{hexdigit_chars, std::size(hexdigit_chars)};
+  static constexpr basic_char_class<CharT> alpha = uppercase | lowercase;
+  static constexpr basic_char_class<CharT> alphanumeric = digits | alpha;
+  // All characters with the Unicode White_Space property, for UTF-16 and UTF-32 text. UTF-8 text needs the utf8_* functions of utf.hpp, as most are multibyte sequences.
+  static constexpr basic_char_class<CharT> unicode_whitespace = detail::make_unicode_whitespace<CharT>();
+};
+
+/** Typedefs for common character types **/
+using char_class = basic_char_class<char>;
+using wchar_class = basic_char_class<wchar_t>;
+using u16char_class = basic_char_class<char16_t>;
+using u32char_class = basic_char_class<char32_t>;
+
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace stdx {
+
+namespace detail {
+
+/** Size of a cache line, used to keep data written by different threads on different lines, and to align storage for vector loads. std::hardware_destructive_interference_size is not used, as its value may differ between compilers and compiler options. */
+constexpr std::size_t cache_line = 64;
+
+/** 2^64 divided by the golden ratio. Multiplying by it spreads the bits of a key into the high bits of the product, as in Fibonacci hashing. */
+constexpr std::uint64_t golden_multiplier = 0x9e3779b97f4a7c15ull;
+
+/** Hash of a sequence of 64-bit words, seeded with the length of the input so inputs padded with zeros hash differently. */
+class word_hash {
+public:
+  explicit constexpr word_hash(std::size_t length) noexcept : h(0xcbf29ce484222325ull ^ (static_cast<std::uint64_t>(length) * golden_multiplier)) { }
+
+  /** Add \p w to the hash. */
+  constexpr void mix(std::uint64_t w) noexcept {
+    h = (h ^ w) * golden_multiplier;
+    h ^= h >> 29;
+  }
+  /** Returns the hash of the words added so far. */
+  constexpr std::uint64_t value() const noexcept { return h ^ (h >> 32); }
+
+private:
+  std::uint64_t h;
+};
+
+/** Hash the \p n bytes at \p data 8 at a time, passing each word (the last padded with zeros) through \p transform before mixing it. */
+template <class Transform>
+inline std::uint64_t hash_bytes(const void* data, std::size_t n, Transform transform) noexcept {
+  const unsigned char* bytes = static_cast<const unsigned char*>(data);
+  word_hash hash(n);
+  std::size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    std::uint64_t w;
+    std::memcpy(&w, bytes + i, 8);
+    hash.mix(transform(w));
+  }
+  if (i < n) {
+    std::uint64_t w = 0;
+    std::memcpy(&w, bytes + i, n - i);
+    hash.mix(transform(w));
+  }
+  return hash.value();
+}
+
+}
+
+}
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+
+#include "common.hpp"
+#include "fixed_vector.hpp"
+
+namespace stdx {
+
+namespace detail {
+
+/** Returns a small number identifying the calling thread, assigned in order of first use. */
+inline unsigned this_thread_ordinal() noexcept {
+  static std::atomic<unsigned> next{0};
+  static thread_local const unsigned ordinal = next.fetch_add(1, std::memory_order_relaxed);
+  return ordinal;
+}
+
+}
+
+/** Concurrent fixed histogram class. A histogram with bins indexed from min to max, like fixed_vector, which many threads can add to at the same time.
+
+ Counts are held in several shards, each a complete set of bins, and each thread adds to the shard chosen by its thread number, using relaxed atomic operations. Shards start on separate cache lines, so threads adding to different shards never contend, and throughput grows with the number of threads. With a single shard, every thread adds to the same relaxed atomics, which uses less memory and suits sparse updates to large histograms.
+
+ Totals are read by folding the shards together with snapshot or merge. Reading while other threads are adding gives a value which includes some, but not necessarily all, of the concurrent additions.
+
+ \tparam T integral type of the counts.
+ */
+template <class T = int64_t>
+class concurrent_fixed_histogram {
+  static_assert(std::is_integral_v<T>, "Histogram counts must be integral");
+
+  static constexpr std::size_t per_line = detail::cache_line >= sizeof(T) ? detail::cache_line / sizeof(T) : 1;
+  struct alignas(detail::cache_line) line {
+    std::atomic<T> counts[per_line];
+  };
+
+public:
+  /* Member types */
+  using value_type = T;
+  using size_type = std::size_t;
+
+  /* Constructors */
+  /** Construct a histogram with zeroed bins in the range \p min to \p max, held in \p shards shards. Defaults to one shard per hardware thread. If \p max < \p min, an exception of type std::range_error is thrown. */
+  concurrent_fixed_histogram(int64_t min, int64_t max, unsigned shards = 0)
+  : minindex(min), maxindex(max), shardcount(shards ? shards : std::max(1u, std::thread::hardware_concurrency())), lines_per_shard(0) {
+    if (max < min) { throw std::range_error("Invalid construction range."); }
+    lines_per_shard = (size() + per_line - 1) / per_line;
+    lines.reset(new line[lines_per_shard * shardcount]);
+    reset();
+  }
+
+  concurrent_fixed_histogram(const concurrent_fixed_histogram&) = delete;
+  concurrent_fixed_histogram& operator=(const concurrent_fixed_histogram&) = delete;
+
+  /** Add \p count to the bin at index \p pos. No bounds checking is performed. */
+  void add(int64_t pos, T count = 1) noexcept {
+    bin(detail::this_thread_ordinal() % shardcount, pos).fetch_add(count, std::memory_order_relaxed);
+  }
+  /** Add \p count to the bin at index \p pos, with bounds checking. If \p pos is not within the range of the histogram, an exception of type std::out_of_range is thrown. */
+  void add_at(int64_t pos, T count = 1) {
+    if (pos < minindex || pos > maxindex) { throw std::out_of_range("concurrent_fixed_histogram::add_at"); }
+    add(pos, count);
+  }
+
+  /** Returns the total of the bin at index \p pos over all shards. No bounds checking is performed. */
+  T operator[](int64_t pos) const noexcept {
+    T total = 0;
+    for (unsigned s = 0; s < shardcount; ++s) { total += bin(s, pos).load(std::memory_order_relaxed); }
+    return total;
+  }
+
+  /** Returns the totals of all bins, folded into a fixed_vector with the same range. */
+  fixed_vector<T> snapshot() const {
+    fixed_vector<T> result(minindex, maxindex, T(0));
+    merge(result);
+    return result;
+  }
+  /** Add the totals of all bins to the bins of \p out with the same indices. If \p out does not have the same range as the histogram, an exception of type std::range_error is thrown. */
+  template <class Allocator>
+  void merge(fixed_vector<T, Allocator>& out) const {
+    if (out.min_index() != minindex || out.max_index() != maxindex || out.size() != size()) {
+      throw std::range_error("Histogram merge range mismatch.");
+    }
+    T* data = out.data();
+    for (unsigned s = 0; s < shardcount; ++s) {
+      const line* shard = lines.get() + std::size_t(s) * lines_per_shard;
+      for (size_type i = 0; i < size(); ++i) { data[i] += shard[i / per_line].counts[i % per_line].load(std::memory_order_relaxed); }
+    }
+  }
+  /** Set all bins to zero. Must not be called while other threads are adding. */
+  void reset() noexcept {
+    for (size_type l = 0; l < lines_per_shard * shardcount; ++l) {
+      for (std::atomic<T>& count : lines[l].counts) { count.store(0, std::memory_order_relaxed); }
+    }
+  }
+
+  /** Returns the number of bins. */
+  size_type size() const noexcept { return static_cast<size_type>(maxindex - minindex + 1); }
+  /** Returns the minimum index. */
+  int64_t min_index() const noexcept { return minindex; }
+  /** Returns the maximum index. */
+  int64_t max_index() const noexcept { return maxindex; }
+  /** Returns the number of shards. */
+  unsigned shard_count() const noexcept { return shardcount; }
+
+private:
+  std::atomic<T>& bin(unsigned shard, int64_t pos) const noexcept {
+    const size_type offset = static_cast<size_type>(pos - minindex);
+    return lines[std::size_t(shard) * lines_per_shard + offset / per_line].counts[offset % per_line];
+  }
+
+  int64_t minindex, maxindex;
+  unsigned shardcount;
+  size_type lines_per_shard;
+  std::unique_ptr<line[]> lines;
+};
+
+}
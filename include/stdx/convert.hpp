@@ -0,0 +1,137 @@
+#pragma once
+
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+
+#include "fixed_vector.hpp"
+#include "instrumentation.hpp"
+
+namespace stdx {
+
+/** Result of a numeric conversion.
+ *  On success \p ec is value-initialised and \p value holds the converted number. On failure \p ec is std::errc::invalid_argument if no number could be parsed, or std::errc::result_out_of_range if the number does not fit in T, and \p value is value-initialised. \p ptr points to the first character not consumed.
+ */
+template <class T>
+struct convert_result {
+  T value;
+  std::errc ec;
+  const char* ptr;
+
+  /** Returns true if the conversion succeeded. */
+  explicit operator bool() const noexcept { return ec == std::errc(); }
+};
+
+/** Result of converting a range of tokens.
+ *  \p in is the position in the input that conversion stopped at, which is the end of the input on success, or the token that failed to convert otherwise. \p out is one past the last value written. \p count is the number of values written.
+ */
+template <class InputIt, class OutputIt>
+struct convert_range_result {
+  InputIt in;
+  OutputIt out;
+  std::size_t count;
+  std::errc ec;
+
+  /** Returns true if every token was converted. */
+  explicit operator bool() const noexcept { return ec == std::errc(); }
+};
+
+namespace detail {
+
+template <class T>
+constexpr bool is_convertible_number_v = (std::is_integral_v<T> && !std::is_same_v<T, bool>) || std::is_floating_point_v<T>;
+
+/** Parse a token consisting only of decimal digits, optionally preceded by '-' for signed types, that is short enough that it cannot overflow. Returns false if the token is not of that form, in which case it must be handed to std::from_chars. */
+template <class T>
+inline bool parse_plain_integer(const char* first, const char* last, T& value) noexcept {
+  using unsigned_type = std::make_unsigned_t<T>;
+  bool negative = false;
+  if constexpr (std::is_signed_v<T>) {
+    if (first != last && *first == '-') { negative = true; ++first; }
+  }
+  const std::ptrdiff_t length = last - first;
+  if (length <= 0 || length > std::numeric_limits<T>::digits10) { return false; }
+  unsigned_type result = 0;
+  for (; first != last; ++first) {
+    const unsigned digit = static_cast<unsigned char>(*first) - static_cast<unsigned>('0');
+    if (digit > 9) { return false; }
+    result = static_cast<unsigned_type>(result * 10 + digit);
+  }
+  value = negative ? static_cast<T>(unsigned_type(0) - result) : static_cast<T>(result);
+  return true;
+}
+
+}
+
+/** Convert \p str to the numeric type T using std::from_chars.
+ *  The whole of \p str must be a number in the format accepted by std::from_chars (decimal for integral types, general for floating point types), otherwise the conversion fails with std::errc::invalid_argument. Conversion does not depend on the current locale and never allocates.
+ */
+template <class T>
+convert_result<T> convert(std::string_view str) noexcept {
+  static_assert(detail::is_convertible_number_v<T>, "Unsupported type conversion");
+  STDX_INSTRUMENT_CALL(convert, str.size(), 1);
+  const char* first = str.data();
+  const char* last = first + str.size();
+  convert_result<T> result{T(), std::errc(), last};
+  if constexpr (std::is_integral_v<T>) {
+    if (detail::parse_plain_integer(first, last, result.value)) { return result; }
+  }
+  auto [ptr, ec] = std::from_chars(first, last, result.value);
+  result.ptr = ptr;
+  result.ec = ec;
+  if (ec == std::errc() && ptr != last) { result.ec = std::errc::invalid_argument; }
+  if (result.ec != std::errc()) { result.value = T(); }
+  return result;
+}
+
+/** Convert a range of tokens to the numeric type T, writing the values to \p out.
+ *  Each token must be convertible to std::string_view. Conversion stops at the first token that fails to convert.
+ */
+template <class T, class InputIt, class OutputIt>
+convert_range_result<InputIt, OutputIt> convert_range(InputIt first, InputIt last, OutputIt out) {
+  std::size_t count = 0;
+  for (; first != last; ++first) {
+    convert_result<T> value = convert<T>(std::string_view(*first));
+    if (!value) { return {first, out, count, value.ec}; }
+    *out = value.value;
+    ++out;
+    ++count;
+  }
+  return {first, out, count, std::errc()};
+}
+
+/** Convert a range of tokens to the numeric type T, appending the values to \p column.
+ *  Storage for all the values is reserved up front when the input is a forward range. Returns the position in the input conversion stopped at and the error, if any.
+ */
+template <class T, class Allocator, class InputIt>
+convert_range_result<InputIt, T*> convert_column(InputIt first, InputIt last, std::vector<T, Allocator>& column) {
+  if constexpr (std::is_base_of_v<std::forward_iterator_tag, typename std::iterator_traits<InputIt>::iterator_category>) {
+    column.reserve(column.size() + static_cast<std::size_t>(std::distance(first, last)));
+  }
+  auto result = convert_range<T>(first, last, std::back_inserter(column));
+  return {result.in, column.data() + column.size(), result.count, result.ec};
+}
+
+/** Convert a forward range of tokens to the numeric type T, replacing the contents of \p column.
+ *  \p column is resized to hold one value per token, with indices starting at \p min. If a token fails to convert, the values from that token onwards are value-initialised. An empty range leaves \p column empty, as a default constructed fixed_vector with its allocator.
+ */
+template <class T, class Allocator, class ForwardIt>
+convert_range_result<ForwardIt, T*> convert_column(ForwardIt first, ForwardIt last, fixed_vector<T, Allocator>& column, int64_t min = 0) {
+  const int64_t count = static_cast<int64_t>(std::distance(first, last));
+  if (count == 0) {
+    column = fixed_vector<T, Allocator>(column.get_allocator());
+    return {first, column.data(), 0, std::errc()};
+  }
+  column.resize(min, min + count - 1);
+  auto result = convert_range<T>(first, last, column.data());
+  std::fill(result.out, column.data() + count, T());
+  return result;
+}
+
+}
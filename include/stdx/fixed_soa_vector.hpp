@@ -0,0 +1,178 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "common.hpp"
+#include "fixed_vector_nd.hpp"
+
+namespace stdx {
+
+namespace detail {
+
+/** Allocator returning storage aligned to at least Align bytes. */
+template <class T, std::size_t Align>
+struct aligned_allocator {
+  static constexpr std::size_t alignment = Align > alignof(T) ? Align : alignof(T);
+
+  using value_type = T;
+  template <class U>
+  struct rebind { using other = aligned_allocator<U, Align>; };
+
+  aligned_allocator() noexcept = default;
+  template <class U>
+  aligned_allocator(const aligned_allocator<U, Align>&) noexcept { }
+
+  T* allocate(std::size_t n) {
+    if (n > static_cast<std::size_t>(-1) / sizeof(T)) { throw std::bad_array_new_length(); }
+    return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(alignment)));
+  }
+  void deallocate(T* p, std::size_t) noexcept { ::operator delete(p, std::align_val_t(alignment)); }
+
+  template <class U>
+  friend bool operator==(const aligned_allocator&, const aligned_allocator<U, Align>&) noexcept { return true; }
+  template <class U>
+  friend bool operator!=(const aligned_allocator&, const aligned_allocator<U, Align>&) noexcept { return false; }
+};
+
+}
+
+/** Fixed structure-of-arrays vector class. Holds records of the types Fields... over a signed index range defined at construction/resize time, like fixed_vector, but stores each field in its own contiguous array.
+
+ Each array starts on a cache line boundary, so a pass which touches only some fields reads only their arrays, and loops over a single field see aligned, unit stride data which the compiler can vectorise. Single fields are accessed through field<K>(), which returns a fixed_view_nd with the same indices as the container, or through data<K>(). operator[] and at return a tuple of references to the fields of one record, which can be assigned from a value_type, or unpacked with structured bindings.
+
+ \tparam Fields types of the fields of each record.
+ */
+template <class... Fields>
+class fixed_soa_vector {
+  static_assert(sizeof...(Fields) > 0, "fixed_soa_vector must have at least one field");
+
+  template <class F>
+  using column_type = std::vector<F, detail::aligned_allocator<F, detail::cache_line>>;
+  using indices = std::index_sequence_for<Fields...>;
+
+public:
+  /* Member types */
+  using value_type = std::tuple<Fields...>;
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+  using reference = std::tuple<Fields&...>;
+  using const_reference = std::tuple<const Fields&...>;
+  template <std::size_t K>
+  using field_type = std::tuple_element_t<K, value_type>;
+  template <std::size_t K>
+  using field_view_type = fixed_view_nd<field_type<K>, 1>;
+  template <std::size_t K>
+  using const_field_view_type = fixed_view_nd<const field_type<K>, 1>;
+
+  /* Static constants */
+  static constexpr size_type field_count = sizeof...(Fields);
+
+  /* Constructors */
+  /** Default constructor.
+   *  Constructs a vector which cannot be filled, as it has zero range.
+   */
+  fixed_soa_vector() noexcept : columns(), minindex(0), maxindex(0) { }
+  /** Construct the container with default-inserted fields in the range \p min to \p max. If \p max < \p min, an exception of type std::range_error is thrown. */
+  fixed_soa_vector(int64_t min, int64_t max) : columns(), minindex(min), maxindex(max) {
+    if (max < min) { throw std::range_error("Invalid construction range."); }
+    resize_columns(static_cast<size_type>(max - min + 1));
+  }
+  /** Construct the container with copies of \p value in the range \p min to \p max. If \p max < \p min, an exception of type std::range_error is thrown. */
+  fixed_soa_vector(int64_t min, int64_t max, const value_type& value) : columns(), minindex(min), maxindex(max) {
+    if (max < min) { throw std::range_error("Invalid construction range."); }
+    resize_columns(static_cast<size_type>(max - min + 1), value);
+  }
+
+  /** Replace the contents with copies of \p value in the range \p min to \p max. If an exception is thrown, the container is unchanged. */
+  void assign(int64_t min, int64_t max, const value_type& value) {
+    *this = fixed_soa_vector(min, max, value);
+  }
+
+  /** Return references to the fields of the record at specified location \p pos, with bounds checking. If \p pos is not within the range of the container, an exception of type std::out_of_range is thrown. */
+  reference at(int64_t pos) {
+    if (pos < minindex || pos > maxindex) { throw std::out_of_range("fixed_soa_vector::at"); }
+    return (*this)[pos];
+  }
+  const_reference at(int64_t pos) const {
+    if (pos < minindex || pos > maxindex) { throw std::out_of_range("fixed_soa_vector::at"); }
+    return (*this)[pos];
+  }
+
+  /** Return references to the fields of the record at specified location \p pos. No bounds checking is performed. */
+  reference operator[](int64_t pos) noexcept { return record<reference>(columns, static_cast<size_type>(pos - minindex), indices()); }
+  const_reference operator[](int64_t pos) const noexcept { return record<const_reference>(columns, static_cast<size_type>(pos - minindex), indices()); }
+
+  /** Returns a view of field \p K of every record, indexed as the container. */
+  template <std::size_t K>
+  field_view_type<K> field() noexcept { return field_view_type<K>(data<K>(), -minindex, {minindex}, {maxindex}, {1}); }
+  template <std::size_t K>
+  const_field_view_type<K> field() const noexcept { return const_field_view_type<K>(data<K>(), -minindex, {minindex}, {maxindex}, {1}); }
+
+  /** Returns a pointer to the array holding field \p K, which is aligned to a cache line. The field of the record at index min_index() is first. */
+  template <std::size_t K>
+  field_type<K>* data() noexcept { return std::get<K>(columns).data(); }
+  template <std::size_t K>
+  const field_type<K>* data() const noexcept { return std::get<K>(columns).data(); }
+
+  /** Returns the number of records. */
+  size_type size() const noexcept { return std::get<0>(columns).size(); }
+  /** Returns the minimum index. */
+  int64_t min_index() const noexcept { return minindex; }
+  /** Returns the maximum index. */
+  int64_t max_index() const noexcept { return maxindex; }
+  /** Resize the bounds of the container. As with fixed_vector, records keep their offset from the minimum index, and new records are default-inserted. If \p max < \p min, an exception of type std::range_error is thrown. If an exception is thrown, the container is unchanged. */
+  void resize(int64_t min, int64_t max) {
+    if (max < min) { throw std::range_error("Invalid resize range."); }
+    resize_columns(static_cast<size_type>(max - min + 1));
+    minindex = min;
+    maxindex = max;
+  }
+  /** Resize the bounds of the container, setting new records to \p value. */
+  void resize(int64_t min, int64_t max, const value_type& value) {
+    if (max < min) { throw std::range_error("Invalid resize range."); }
+    resize_columns(static_cast<size_type>(max - min + 1), value);
+    minindex = min;
+    maxindex = max;
+  }
+
+private:
+  template <class Ref, class Columns, std::size_t... K>
+  static Ref record(Columns& columns, size_type offset, std::index_sequence<K...>) noexcept {
+    return Ref(std::get<K>(columns)[offset]...);
+  }
+
+  /* Growing reserves every column before \p grow inserts the new records, so if construction of a record throws, every column can be returned to the old size. */
+  template <class Grow, std::size_t... K>
+  void resize_columns(size_type n, Grow grow, std::index_sequence<K...>) {
+    const size_type old_size = size();
+    if (n <= old_size) {
+      (std::get<K>(columns).erase(std::get<K>(columns).begin() + n, std::get<K>(columns).end()), ...);
+      return;
+    }
+    try {
+      (std::get<K>(columns).reserve(n), ...);
+      (grow(std::get<K>(columns), std::integral_constant<std::size_t, K>()), ...);
+    } catch (...) {
+      (std::get<K>(columns).erase(std::get<K>(columns).begin() + old_size, std::get<K>(columns).end()), ...);
+      throw;
+    }
+  }
+  void resize_columns(size_type n) {
+    resize_columns(n, [n](auto& column, auto) { column.resize(n); }, indices());
+  }
+  void resize_columns(size_type n, const value_type& value) {
+    resize_columns(n, [n, &value](auto& column, auto k) { column.resize(n, std::get<decltype(k)::value>(value)); }, indices());
+  }
+
+  std::tuple<column_type<Fields>...> columns;
+  int64_t minindex, maxindex;
+};
+
+}
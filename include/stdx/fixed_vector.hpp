@@ -2,9 +2,16 @@
 
 #include <algorithm>
 #include <cstdint>
+#include <initializer_list>
 #include <iterator>
+#include <memory>
+#include <memory_resource>
+#include <stdexcept>
+#include <type_traits>
 #include <vector>
 
+#include "instrumentation.hpp"
+
 namespace stdx {
 
 /** Fixed vector class. Is a dynamic vector that is size constrained at construction/resize time. Can have negative indices as defined at construction time.
@@ -15,13 +22,13 @@ class fixed_vector {
 public:
   /* Member types */
   using value_type = typename base_type::value_type;
-  using allocator_type = typename base_type::value_type;
+  using allocator_type = typename base_type::allocator_type;
   using size_type = typename base_type::size_type;
   using difference_type = typename base_type::difference_type;
   using reference = typename base_type::reference;
   using const_reference = typename base_type::const_reference;
   using pointer = typename base_type::pointer;
-  using const_pointer = typename base_type::pointer;
+  using const_pointer = typename base_type::const_pointer;
   using iterator = typename base_type::iterator;
   using const_iterator = typename base_type::const_iterator;
   using reverse_iterator = typename base_type::reverse_iterator;
@@ -34,20 +41,20 @@ public:
   fixed_vector() noexcept(noexcept(Allocator())): elems(), minindex(0), maxindex(0) { }
   explicit fixed_vector(const Allocator& alloc) noexcept : elems(alloc), minindex(0), maxindex(0) { }
   
-  /** Construct the container with copies of \p value in the range \p min to \p max. */
+  /** Construct the container with copies of \p value in the range \p min to \p max. If \p max < \p min, an exception of type std::range_error is thrown. */
   fixed_vector(int64_t min, int64_t max, const T& value, const Allocator& alloc = Allocator())
-  : elems(max > min ? max - min + 1 : 0, value, alloc), minindex(min), maxindex(max) {
-    if (max <= min) { throw std::range_error("Invalid construction range."); }
+  : elems(max >= min ? max - min + 1 : 0, value, alloc), minindex(min), maxindex(max) {
+    if (max < min) { throw std::range_error("Invalid construction range."); }
   }
-  /** Construct the container with default-inserted instances of T in the range \p min to \p max. */
+  /** Construct the container with default-inserted instances of T in the range \p min to \p max. If \p max < \p min, an exception of type std::range_error is thrown. */
   fixed_vector(int64_t min, int64_t max, const Allocator& alloc = Allocator())
-  : elems(max > min ? max - min + 1 : 0, alloc), minindex(min), maxindex(max) {
-    if (max <= min) { throw std::range_error("Invalid construction range."); }
+  : elems(max >= min ? max - min + 1 : 0, alloc), minindex(min), maxindex(max) {
+    if (max < min) { throw std::range_error("Invalid construction range."); }
   }
   /** Construct with contents of the range [\p first, \p last). \p maxindex is calculated based on the construction range. */
-  template <class InputIt>
+  template <class InputIt, class = std::enable_if_t<!std::is_integral_v<InputIt>>>
   fixed_vector(int64_t min, InputIt first, InputIt last, const Allocator& alloc = Allocator())
-  : elems(first, last, alloc), minindex(min), maxindex(min + std::distance(first, last)) { }
+  : elems(first, last, alloc), minindex(min), maxindex(min + static_cast<int64_t>(elems.size()) - 1) { }
   
   /** Copy constructor */
   fixed_vector(const fixed_vector& other)
@@ -63,7 +70,7 @@ public:
   
   /** Initialiser list constructor. */
   fixed_vector(int64_t min, std::initializer_list<T> init, const Allocator& alloc = Allocator())
-  : elems(init, alloc), minindex(min), maxindex(min + init.size()) { }
+  : elems(init, alloc), minindex(min), maxindex(min + static_cast<int64_t>(init.size()) - 1) { }
   
   /** Destructor. */
   ~fixed_vector() { }
@@ -88,23 +95,26 @@ public:
   }
   // No initializer list assignment
   
-  /** Replace the contents with copies of \p value. */
+  /** Replace the contents with copies of \p value in the range \p min to \p max. If \p max < \p min, an exception of type std::range_error is thrown. */
   void assign(int64_t min, int64_t max, const T& value) {
-    if (max <= min) { throw std::range_error("Invalid assign range."); }
+    if (max < min) { throw std::range_error("Invalid assign range."); }
+    STDX_INSTRUMENT_VECTOR(assign, elems);
     elems.assign(max - min + 1, value);
     minindex = min;
     maxindex = max;
   }
-  template <class InputIt>
+  template <class InputIt, class = std::enable_if_t<!std::is_integral_v<InputIt>>>
   void assign(int64_t min, InputIt first, InputIt last) {
+    STDX_INSTRUMENT_VECTOR(assign, elems);
     elems.assign(first, last);
     minindex = min;
-    maxindex = min + elems.size();
+    maxindex = min + static_cast<int64_t>(elems.size()) - 1;
   }
   void assign(int64_t min, std::initializer_list<T> ilist) {
+    STDX_INSTRUMENT_VECTOR(assign, elems);
     elems.assign(ilist);
     minindex = min;
-    maxindex = min + elems.size();
+    maxindex = min + static_cast<int64_t>(elems.size()) - 1;
   }
   
   /** Returns the allocator associated with the container. */
@@ -160,26 +170,64 @@ public:
   const_reverse_iterator crend() const noexcept { return elems.crend(); }
   
   /** Returns the number of elements. */
-  size_type size() const { elems.size(); }
+  size_type size() const { return elems.size(); }
   /** Returns the minimum index. */
   int64_t min_index() const { return minindex; }
   /** Returns the maximum index. */
   int64_t max_index() const { return maxindex; }
-  /** Resize the bounds of the container. */
+  /** Resize the bounds of the container. If \p max < \p min, an exception of type std::range_error is thrown. */
   void resize(int64_t min, int64_t max) {
+    if (max < min) { throw std::range_error("Invalid resize range."); }
     minindex = min;
     maxindex = max;
+    STDX_INSTRUMENT_VECTOR(resize, elems);
     elems.resize(maxindex - minindex + 1);
   }
   void resize(int64_t min, int64_t max, const value_type& value) {
+    if (max < min) { throw std::range_error("Invalid resize range."); }
     minindex = min;
     maxindex = max;
+    STDX_INSTRUMENT_VECTOR(resize, elems);
     elems.resize(maxindex - minindex + 1, value);
   }
+  /** Move the bounds of the container to [\p min, \p max], keeping elements at their indices.
+   *  Elements whose indices are in both the old and new ranges keep their values, and all other elements in the new range are set to \p value. Takes time proportional to the size of the new range, and only reallocates if the new range is larger than the capacity of the container. For windows that advance continuously, ring_fixed_vector avoids moving the overlapping elements altogether. If \p max < \p min, an exception of type std::range_error is thrown.
+   */
+  void slide(int64_t min, int64_t max, const value_type& value = value_type()) {
+    if (max < min) { throw std::range_error("Invalid slide range."); }
+    const int64_t lo = std::max(min, minindex), hi = std::min(max, maxindex);
+    const size_type new_size = static_cast<size_type>(max - min + 1);
+    if (lo > hi || elems.empty()) {
+      // No overlap, or a default constructed container with no elements
+      elems.assign(new_size, value);
+    } else if (min >= minindex) {
+      // Overlapping elements move towards the front
+      const size_type kept = static_cast<size_type>(hi - lo + 1);
+      std::move(elems.begin() + (lo - minindex), elems.begin() + (hi - minindex + 1), elems.begin());
+      std::fill(elems.begin() + kept, elems.begin() + std::min(elems.size(), new_size), value);
+      elems.resize(new_size, value);
+    } else {
+      // Overlapping elements move towards the back
+      const size_type kept = static_cast<size_type>(hi - lo + 1);
+      const size_type shift = static_cast<size_type>(minindex - min);
+      if (new_size > elems.size()) { elems.resize(new_size, value); }
+      std::move_backward(elems.begin(), elems.begin() + kept, elems.begin() + (shift + kept));
+      std::fill(elems.begin(), elems.begin() + shift, value);
+      std::fill(elems.begin() + (shift + kept), elems.begin() + new_size, value);
+      elems.erase(elems.begin() + new_size, elems.end());
+    }
+    minindex = min;
+    maxindex = max;
+  }
   
 protected:
   base_type elems;
   int64_t minindex, maxindex;
 };
 
+namespace pmr {
+template <class T>
+using fixed_vector = stdx::fixed_vector<T, std::pmr::polymorphic_allocator<T>>;
+}
+
 }
@@ -0,0 +1,289 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+namespace stdx {
+
+/** Order in which the elements of a multi-dimensional container are stored. With row_major the last index varies fastest, with column_major the first. */
+enum class layout { row_major, column_major };
+
+/** Non-owning view of a multi-dimensional array with arbitrary, possibly negative, bounds in each dimension.
+
+ Element (i0, i1, ...) is found at offset origin + sum(i_d * stride_d) from the base pointer. Views are obtained from fixed_vector_nd, and by slicing other views, and are invalidated by anything that invalidates the storage they refer to.
+
+ \tparam T element type. May be const qualified for read-only views.
+ \tparam N number of dimensions.
+ */
+template <class T, std::size_t N>
+class fixed_view_nd {
+  static_assert(N > 0, "fixed_view_nd must have at least one dimension");
+public:
+  /* Member types */
+  using value_type = std::remove_cv_t<T>;
+  using size_type = std::size_t;
+  using reference = T&;
+  using pointer = T*;
+  using index_type = std::array<int64_t, N>;
+
+  /* Constructors */
+  /** Construct a view of the elements base[origin + sum(i_d * strides_d)], for i_d in [min_d, max_d]. */
+  fixed_view_nd(T* base, int64_t origin, const index_type& min, const index_type& max, const index_type& strides) noexcept
+  : base(base), origin(origin), minindex(min), maxindex(max), strides(strides) { }
+
+  /** Conversion from a view of non-const elements to a view of const elements. */
+  template <class U, class = std::enable_if_t<std::is_same_v<const U, T> && !std::is_same_v<U, T>>>
+  fixed_view_nd(const fixed_view_nd<U, N>& other) noexcept
+  : base(other.base), origin(other.origin), minindex(other.minindex), maxindex(other.maxindex), strides(other.strides) { }
+
+  /** Returns a reference to the element at the given indices. No bounds checking is performed. */
+  template <class... Idx>
+  reference operator()(Idx... idx) const noexcept {
+    static_assert(sizeof...(Idx) == N, "Wrong number of indices");
+    return base[offset(index_type{static_cast<int64_t>(idx)...})];
+  }
+  reference operator[](const index_type& idx) const noexcept { return base[offset(idx)]; }
+  /** Returns a reference to the element at \p pos of a one-dimensional view. No bounds checking is performed. */
+  template <std::size_t M = N, class = std::enable_if_t<M == 1>>
+  reference operator[](int64_t pos) const noexcept { return base[origin + pos * strides[0]]; }
+
+  /** Returns a reference to the element at the given indices, with bounds checking. If any index is out of range, an exception of type std::out_of_range is thrown. */
+  template <class... Idx>
+  reference at(Idx... idx) const {
+    static_assert(sizeof...(Idx) == N, "Wrong number of indices");
+    return at(index_type{static_cast<int64_t>(idx)...});
+  }
+  reference at(const index_type& idx) const {
+    for (size_type d = 0; d < N; ++d) {
+      if (idx[d] < minindex[d] || idx[d] > maxindex[d]) { throw std::out_of_range("fixed_view_nd::at"); }
+    }
+    return base[offset(idx)];
+  }
+
+  /** Returns the view of dimension N - 1 obtained by fixing the index of dimension \p dim to \p index. No bounds checking is performed. */
+  template <std::size_t M = N, class = std::enable_if_t<(M > 1)>>
+  fixed_view_nd<T, N - 1> slice(size_type dim, int64_t index) const noexcept {
+    std::array<int64_t, N - 1> min{}, max{}, stride{};
+    for (size_type d = 0, k = 0; d < N; ++d) {
+      if (d == dim) { continue; }
+      min[k] = minindex[d];
+      max[k] = maxindex[d];
+      stride[k] = strides[d];
+      ++k;
+    }
+    return fixed_view_nd<T, N - 1>(base, origin + index * strides[dim], min, max, stride);
+  }
+
+  /** Returns a pointer to the element at the minimum index of every dimension. */
+  pointer data() const noexcept { return base + offset(minindex); }
+
+  /** Returns the minimum index of dimension \p dim. */
+  int64_t min_index(size_type dim) const noexcept { return minindex[dim]; }
+  /** Returns the maximum index of dimension \p dim. */
+  int64_t max_index(size_type dim) const noexcept { return maxindex[dim]; }
+  /** Returns the number of indices in dimension \p dim. */
+  size_type extent(size_type dim) const noexcept { return static_cast<size_type>(maxindex[dim] - minindex[dim] + 1); }
+  /** Returns the distance in elements between consecutive indices of dimension \p dim. */
+  int64_t stride(size_type dim) const noexcept { return strides[dim]; }
+  /** Returns the total number of elements. */
+  size_type size() const noexcept {
+    size_type result = 1;
+    for (size_type d = 0; d < N; ++d) { result *= extent(d); }
+    return result;
+  }
+  /** Returns true if the elements of a one-dimensional view are adjacent in memory, so [data(), data() + size()) is a valid range. */
+  template <std::size_t M = N, class = std::enable_if_t<M == 1>>
+  bool is_contiguous() const noexcept { return strides[0] == 1; }
+
+private:
+  template <class U, std::size_t M> friend class fixed_view_nd;
+
+  int64_t offset(const index_type& idx) const noexcept {
+    int64_t result = origin;
+    for (size_type d = 0; d < N; ++d) { result += idx[d] * strides[d]; }
+    return result;
+  }
+
+  T* base;
+  int64_t origin;
+  index_type minindex, maxindex, strides;
+};
+
+/** Multi-dimensional fixed vector. Each dimension has its own, possibly negative, index range defined at construction time.
+
+ Elements are held in a single contiguous allocation, in the order given by Layout. Strides are computed at construction, and the stride of the fastest varying dimension is always one, so loops over that dimension access adjacent elements.
+
+ \tparam T element type.
+ \tparam N number of dimensions.
+ \tparam Layout order in which elements are stored.
+ \tparam Allocator allocator used to allocate the element storage.
+ */
+template <class T, std::size_t N, layout Layout = layout::row_major, class Allocator = std::allocator<T>>
+class fixed_vector_nd {
+  static_assert(N > 0, "fixed_vector_nd must have at least one dimension");
+  using base_type = std::vector<T, Allocator>;
+  static constexpr std::size_t fastest = Layout == layout::row_major ? N - 1 : 0;
+public:
+  /* Member types */
+  using value_type = T;
+  using allocator_type = Allocator;
+  using size_type = typename base_type::size_type;
+  using difference_type = typename base_type::difference_type;
+  using reference = typename base_type::reference;
+  using const_reference = typename base_type::const_reference;
+  using pointer = typename base_type::pointer;
+  using const_pointer = typename base_type::const_pointer;
+  using iterator = typename base_type::iterator;
+  using const_iterator = typename base_type::const_iterator;
+  using index_type = std::array<int64_t, N>;
+  using view_type = fixed_view_nd<T, N>;
+  using const_view_type = fixed_view_nd<const T, N>;
+
+  /* Constructors */
+  /** Default constructor.
+   *  Constructs a container with no elements.
+   */
+  fixed_vector_nd() noexcept(noexcept(Allocator())) : elems(), minindex{}, maxindex{}, strides{}, origin(0) {
+    for (size_type d = 0; d < N; ++d) { maxindex[d] = -1; }
+  }
+  explicit fixed_vector_nd(const Allocator& alloc) noexcept : elems(alloc), minindex{}, maxindex{}, strides{}, origin(0) {
+    for (size_type d = 0; d < N; ++d) { maxindex[d] = -1; }
+  }
+
+  /** Construct the container with copies of \p value for indices in [\p min_d, \p max_d] in each dimension. If any \p max_d < \p min_d, an exception of type std::range_error is thrown. */
+  fixed_vector_nd(const index_type& min, const index_type& max, const T& value, const Allocator& alloc = Allocator())
+  : elems(alloc), minindex(min), maxindex(max), strides{}, origin(0) {
+    elems.assign(compute_layout(), value);
+  }
+  /** Construct the container with default-inserted instances of T for indices in [\p min_d, \p max_d] in each dimension. If any \p max_d < \p min_d, an exception of type std::range_error is thrown. */
+  fixed_vector_nd(const index_type& min, const index_type& max, const Allocator& alloc = Allocator())
+  : elems(alloc), minindex(min), maxindex(max), strides{}, origin(0) {
+    elems.resize(compute_layout());
+  }
+
+  /** Replace the contents with copies of \p value for indices in [\p min_d, \p max_d] in each dimension. */
+  void assign(const index_type& min, const index_type& max, const T& value) {
+    index_type old_min = minindex, old_max = maxindex;
+    minindex = min;
+    maxindex = max;
+    try {
+      elems.assign(compute_layout(), value);
+    } catch (...) {
+      minindex = old_min;
+      maxindex = old_max;
+      compute_layout();
+      throw;
+    }
+  }
+
+  /** Returns the allocator associated with the container. */
+  allocator_type get_allocator() const noexcept { return elems.get_allocator(); }
+
+  /** Returns a reference to the element at the given indices. No bounds checking is performed. */
+  template <class... Idx>
+  reference operator()(Idx... idx) noexcept {
+    static_assert(sizeof...(Idx) == N, "Wrong number of indices");
+    return elems[offset(index_type{static_cast<int64_t>(idx)...})];
+  }
+  template <class... Idx>
+  const_reference operator()(Idx... idx) const noexcept {
+    static_assert(sizeof...(Idx) == N, "Wrong number of indices");
+    return elems[offset(index_type{static_cast<int64_t>(idx)...})];
+  }
+  reference operator[](const index_type& idx) noexcept { return elems[offset(idx)]; }
+  const_reference operator[](const index_type& idx) const noexcept { return elems[offset(idx)]; }
+
+  /** Returns a reference to the element at the given indices, with bounds checking. If any index is out of range, an exception of type std::out_of_range is thrown. */
+  template <class... Idx>
+  reference at(Idx... idx) {
+    static_assert(sizeof...(Idx) == N, "Wrong number of indices");
+    return elems[checked_offset(index_type{static_cast<int64_t>(idx)...})];
+  }
+  template <class... Idx>
+  const_reference at(Idx... idx) const {
+    static_assert(sizeof...(Idx) == N, "Wrong number of indices");
+    return elems[checked_offset(index_type{static_cast<int64_t>(idx)...})];
+  }
+  reference at(const index_type& idx) { return elems[checked_offset(idx)]; }
+  const_reference at(const index_type& idx) const { return elems[checked_offset(idx)]; }
+
+  /** Returns a view of the whole container. */
+  view_type view() noexcept { return view_type(elems.data(), origin, minindex, maxindex, strides); }
+  const_view_type view() const noexcept { return const_view_type(elems.data(), origin, minindex, maxindex, strides); }
+
+  /** Returns the view of dimension N - 1 obtained by fixing the index of dimension \p dim to \p index. No bounds checking is performed. */
+  template <std::size_t M = N, class = std::enable_if_t<(M > 1)>>
+  fixed_view_nd<T, N - 1> slice(size_type dim, int64_t index) noexcept { return view().slice(dim, index); }
+  template <std::size_t M = N, class = std::enable_if_t<(M > 1)>>
+  fixed_view_nd<const T, N - 1> slice(size_type dim, int64_t index) const noexcept { return view().slice(dim, index); }
+
+  /** Returns pointer to the underlying array serving as element storage, in the order given by Layout. */
+  T* data() noexcept { return elems.data(); }
+  const T* data() const noexcept { return elems.data(); }
+
+  /** Iterators over the elements in storage order. */
+  iterator begin() noexcept { return elems.begin(); }
+  const_iterator begin() const noexcept { return elems.begin(); }
+  const_iterator cbegin() const noexcept { return elems.cbegin(); }
+  iterator end() noexcept { return elems.end(); }
+  const_iterator end() const noexcept { return elems.end(); }
+  const_iterator cend() const noexcept { return elems.cend(); }
+
+  /** Returns the total number of elements. */
+  size_type size() const noexcept { return elems.size(); }
+  /** Returns the minimum index of dimension \p dim. */
+  int64_t min_index(size_type dim) const noexcept { return minindex[dim]; }
+  /** Returns the maximum index of dimension \p dim. */
+  int64_t max_index(size_type dim) const noexcept { return maxindex[dim]; }
+  /** Returns the number of indices in dimension \p dim. */
+  size_type extent(size_type dim) const noexcept { return static_cast<size_type>(maxindex[dim] - minindex[dim] + 1); }
+  /** Returns the distance in elements between consecutive indices of dimension \p dim. */
+  int64_t stride(size_type dim) const noexcept { return strides[dim]; }
+
+private:
+  /** Compute strides and origin from the bounds, returning the number of elements. */
+  size_type compute_layout() {
+    int64_t step = 1;
+    for (size_type k = 0; k < N; ++k) {
+      const size_type d = Layout == layout::row_major ? N - 1 - k : k;
+      if (maxindex[d] < minindex[d]) { throw std::range_error("Invalid construction range."); }
+      strides[d] = step;
+      step *= maxindex[d] - minindex[d] + 1;
+    }
+    origin = 0;
+    for (size_type d = 0; d < N; ++d) { origin -= minindex[d] * strides[d]; }
+    return static_cast<size_type>(step);
+  }
+
+  int64_t offset(const index_type& idx) const noexcept {
+    // The stride of the fastest varying dimension is always one, so leave it out to let the compiler see unit stride
+    int64_t result = origin + idx[fastest];
+    for (size_type d = 0; d < N; ++d) {
+      if (d != fastest) { result += idx[d] * strides[d]; }
+    }
+    return result;
+  }
+  int64_t checked_offset(const index_type& idx) const {
+    for (size_type d = 0; d < N; ++d) {
+      if (idx[d] < minindex[d] || idx[d] > maxindex[d]) { throw std::out_of_range("fixed_vector_nd::at"); }
+    }
+    return offset(idx);
+  }
+
+  base_type elems;
+  index_type minindex, maxindex, strides;
+  int64_t origin;
+};
+
+namespace pmr {
+template <class T, std::size_t N, layout Layout = layout::row_major>
+using fixed_vector_nd = stdx::fixed_vector_nd<T, N, Layout, std::pmr::polymorphic_allocator<T>>;
+}
+
+}
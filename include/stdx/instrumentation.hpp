@@ -0,0 +1,263 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace stdx {
+
+/** Opt-in counters of the work done by stdx operations.
+
+ When the program is compiled with STDX_INSTRUMENT defined (the STDX_INSTRUMENT CMake option), strip, split, join, substr, convert and fixed_vector resize and assign count their calls, the bytes of input they scan, and the allocations made for the containers they produce or grow, with the bytes allocated. Allocations are judged from the capacity of those containers, so strings held in the small string buffer are not counted, and allocations made by element types are not seen. Without STDX_INSTRUMENT the counting macros expand to nothing, and the operations are unchanged. STDX_INSTRUMENT must be defined the same way in every translation unit of the program.
+
+ Each thread counts into its own counters, without synchronisation beyond relaxed atomic loads and stores. snapshot adds together the counters of every thread, including threads which have exited, so it can be called at any time from any thread. reset never writes to the counters of other threads, instead recording their current values as a baseline for later snapshots to subtract, so it can also be called at any time.
+ */
+namespace instrumentation {
+
+/** The instrumented operations. */
+enum class operation : unsigned { strip, split, join, substr, convert, resize, assign };
+constexpr std::size_t operation_count = 7;
+
+/** Returns the name of \p op. */
+constexpr const char* name(operation op) noexcept {
+  constexpr const char* names[operation_count] = {"strip", "split", "join", "substr", "convert", "resize", "assign"};
+  return names[static_cast<std::size_t>(op)];
+}
+
+/** Counts for one operation. */
+struct counters {
+  uint64_t calls = 0;
+  uint64_t allocations = 0;
+  uint64_t bytes_allocated = 0;
+  uint64_t bytes_scanned = 0;
+
+  counters& operator+=(const counters& other) noexcept {
+    calls += other.calls;
+    allocations += other.allocations;
+    bytes_allocated += other.bytes_allocated;
+    bytes_scanned += other.bytes_scanned;
+    return *this;
+  }
+};
+
+/** Counts for every operation, as returned by snapshot. */
+class report {
+public:
+  /** Returns the counts for \p op. */
+  const counters& operator[](operation op) const noexcept { return ops[static_cast<std::size_t>(op)]; }
+  counters& operator[](operation op) noexcept { return ops[static_cast<std::size_t>(op)]; }
+  /** Returns the counts summed over all operations. */
+  counters total() const noexcept {
+    counters result;
+    for (const counters& c : ops) { result += c; }
+    return result;
+  }
+  /** Call \p f(operation, counters) for each operation. */
+  template <class F>
+  void for_each(F f) const {
+    for (std::size_t i = 0; i < operation_count; ++i) { f(static_cast<operation>(i), ops[i]); }
+  }
+
+private:
+  std::array<counters, operation_count> ops{};
+};
+
+/** Function receiving the counters when they are exported. */
+using export_hook = std::function<void(const report&)>;
+
+}
+
+namespace detail {
+
+/* Counters of one thread. Only the owning thread adds to them, so increments are a relaxed load and store rather than a read-modify-write. Resetting records the values as a baseline instead of clearing them, so it never races with the owner's stores; baselines are only written with the registry mutex held. */
+struct thread_counters {
+  static constexpr std::size_t fields = 4;
+  std::atomic<uint64_t> values[instrumentation::operation_count][fields];
+  std::atomic<uint64_t> baseline[instrumentation::operation_count][fields];
+
+  thread_counters() noexcept {
+    for (std::size_t i = 0; i < instrumentation::operation_count; ++i) {
+      for (std::size_t f = 0; f < fields; ++f) {
+        values[i][f].store(0, std::memory_order_relaxed);
+        baseline[i][f].store(0, std::memory_order_relaxed);
+      }
+    }
+  }
+  void add(instrumentation::operation op, std::size_t field, uint64_t n) noexcept {
+    std::atomic<uint64_t>& value = values[static_cast<std::size_t>(op)][field];
+    value.store(value.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+  }
+  /* Returns the count of \p field of operation \p i since the last reset. */
+  uint64_t since_reset(std::size_t i, std::size_t field) const noexcept {
+    return values[i][field].load(std::memory_order_relaxed) - baseline[i][field].load(std::memory_order_relaxed);
+  }
+  void add_to(instrumentation::report& out) const noexcept {
+    for (std::size_t i = 0; i < instrumentation::operation_count; ++i) {
+      instrumentation::counters& c = out[static_cast<instrumentation::operation>(i)];
+      c.calls += since_reset(i, 0);
+      c.allocations += since_reset(i, 1);
+      c.bytes_allocated += since_reset(i, 2);
+      c.bytes_scanned += since_reset(i, 3);
+    }
+  }
+  void reset() noexcept {
+    for (std::size_t i = 0; i < instrumentation::operation_count; ++i) {
+      for (std::size_t f = 0; f < fields; ++f) { baseline[i][f].store(values[i][f].load(std::memory_order_relaxed), std::memory_order_relaxed); }
+    }
+  }
+};
+
+/* Counters of all live threads, and the totals of threads which have exited. */
+struct instrumentation_registry {
+  std::mutex mutex;
+  std::vector<thread_counters*> live;
+  instrumentation::report retired;
+  instrumentation::export_hook hook;
+};
+inline instrumentation_registry& instrumentation_registry_instance() {
+  static instrumentation_registry registry;
+  return registry;
+}
+
+/* Registers the counters of a thread on its first use, and folds them into the retired totals when the thread exits. */
+struct thread_counters_registration {
+  thread_counters counters;
+
+  thread_counters_registration() noexcept {
+    // Counting must not throw from the noexcept operations it is used in. If registration fails, this thread's counts are only seen by thread_snapshot.
+    try {
+      instrumentation_registry& registry = instrumentation_registry_instance();
+      std::lock_guard<std::mutex> lock(registry.mutex);
+      registry.live.push_back(&counters);
+    } catch (...) { }
+  }
+  ~thread_counters_registration() {
+    instrumentation_registry& registry = instrumentation_registry_instance();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    counters.add_to(registry.retired);
+    for (std::size_t i = 0; i < registry.live.size(); ++i) {
+      if (registry.live[i] == &counters) {
+        registry.live[i] = registry.live.back();
+        registry.live.pop_back();
+        break;
+      }
+    }
+  }
+};
+inline thread_counters& this_thread_counters() noexcept {
+  static thread_local thread_counters_registration registration;
+  return registration.counters;
+}
+
+/** Count a call of \p op which scanned \p scanned code units of \p unit_size bytes. */
+inline void instrument_call(instrumentation::operation op, std::size_t scanned, std::size_t unit_size = 1) noexcept {
+  thread_counters& counters = this_thread_counters();
+  counters.add(op, 0, 1);
+  counters.add(op, 3, static_cast<uint64_t>(scanned) * unit_size);
+}
+/** Count an allocation of \p bytes made by \p op. */
+inline void instrument_allocation(instrumentation::operation op, std::size_t bytes) noexcept {
+  thread_counters& counters = this_thread_counters();
+  counters.add(op, 1, 1);
+  counters.add(op, 2, bytes);
+}
+/** Count the allocation holding \p str, if its characters are not held in the small string buffer. */
+template <class String>
+inline void instrument_string(instrumentation::operation op, const String& str) {
+  static const std::size_t inline_capacity = String(str.get_allocator()).capacity();
+  if (str.capacity() > inline_capacity) { instrument_allocation(op, (str.capacity() + 1) * sizeof(typename String::value_type)); }
+}
+/** Counts a call of \p op on \p vec, and the allocation made if its capacity grows before the scope ends. */
+template <class Vector>
+class instrument_vector_scope {
+public:
+  instrument_vector_scope(instrumentation::operation counted, const Vector& watched) : op(counted), vec(watched), capacity(watched.capacity()) {
+    instrument_call(op, 0);
+  }
+  ~instrument_vector_scope() {
+    if (vec.capacity() > capacity) { instrument_allocation(op, vec.capacity() * sizeof(typename Vector::value_type)); }
+  }
+  instrument_vector_scope(const instrument_vector_scope&) = delete;
+  instrument_vector_scope& operator=(const instrument_vector_scope&) = delete;
+
+private:
+  instrumentation::operation op;
+  const Vector& vec;
+  std::size_t capacity;
+};
+
+}
+
+namespace instrumentation {
+
+/** Returns the counters summed over all threads. Counts made by other threads while the snapshot is taken may or may not be included. */
+inline report snapshot() {
+  detail::instrumentation_registry& registry = detail::instrumentation_registry_instance();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  report result = registry.retired;
+  for (const detail::thread_counters* counters : registry.live) { counters->add_to(result); }
+  return result;
+}
+/** Returns the counters of the calling thread. */
+inline report thread_snapshot() {
+  report result;
+  detail::this_thread_counters().add_to(result);
+  return result;
+}
+/** Set the counters of all threads to zero. Counts made by other threads while resetting are included either before or after the reset, and are never lost. */
+inline void reset() {
+  detail::instrumentation_registry& registry = detail::instrumentation_registry_instance();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  registry.retired = report();
+  for (detail::thread_counters* counters : registry.live) { counters->reset(); }
+}
+
+/** Set the function called by export_counters, replacing any previous one. An empty function removes the hook. */
+inline void set_export_hook(export_hook hook) {
+  detail::instrumentation_registry& registry = detail::instrumentation_registry_instance();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  registry.hook = std::move(hook);
+}
+/** Pass a snapshot of the counters to the export hook, if one is set, and optionally reset them. Call periodically, for example from a metrics reporting thread. */
+inline void export_counters(bool reset_after = false) {
+  export_hook hook;
+  {
+    detail::instrumentation_registry& registry = detail::instrumentation_registry_instance();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    hook = registry.hook;
+  }
+  if (!hook) { return; }
+  const report counts = snapshot();
+  if (reset_after) { reset(); }
+  hook(counts);
+}
+
+/** Returns true if the library was compiled with instrumentation enabled. */
+constexpr bool enabled() noexcept {
+#ifdef STDX_INSTRUMENT
+  return true;
+#else
+  return false;
+#endif
+}
+
+}
+
+}
+
+/* Counting hooks used by the instrumented operations. They expand to nothing unless STDX_INSTRUMENT is defined. */
+#ifdef STDX_INSTRUMENT
+#define STDX_INSTRUMENT_CALL(op, scanned, unit_size) ::stdx::detail::instrument_call(::stdx::instrumentation::operation::op, (scanned), (unit_size))
+#define STDX_INSTRUMENT_STRING(op, str) ::stdx::detail::instrument_string(::stdx::instrumentation::operation::op, (str))
+#define STDX_INSTRUMENT_VECTOR(op, vec) ::stdx::detail::instrument_vector_scope<std::decay_t<decltype(vec)>> stdx_instrument_scope_(::stdx::instrumentation::operation::op, (vec))
+#else
+#define STDX_INSTRUMENT_CALL(op, scanned, unit_size) ((void)0)
+#define STDX_INSTRUMENT_STRING(op, str) ((void)0)
+#define STDX_INSTRUMENT_VECTOR(op, vec) ((void)0)
+#endif
@@ -0,0 +1,241 @@
+#pragma once
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#include "char_class.hpp"
+#include "mapped_file.hpp"
+#include "string.hpp"
+#include "string_algorithms.hpp"
+
+namespace stdx {
+
+/** Streaming reader yielding the lines of a file as string views.
+
+ Regular files are memory mapped on POSIX systems, so lines refer directly to the mapped file. Other inputs, such as pipes, and files reporting a size of zero, such as those under /proc, are read through a single reusable buffer, which grows if a line does not fit in it. In either case reading never copies a line more than once.
+
+ On POSIX systems the buffer is filled by reading the file descriptor directly, taking whatever a single read returns, so lines from pipes and terminals are returned as they arrive. Elsewhere it is filled with fread, which blocks until the buffer is full or the input ends.
+
+ Lines are separated by '\n', which is not included in the line. A '\r' directly preceding the '\n' is also removed, so files with CRLF line endings are handled. A final line without a trailing newline is still returned.
+
+ A line returned by next is valid until the next call to next, or the destruction of the reader. Errors are reported by throwing std::system_error.
+ */
+class line_reader {
+public:
+  static constexpr std::size_t default_buffer_size = std::size_t(1) << 20;
+
+  /** Input iterator over the remaining lines of a line_reader. */
+  class iterator {
+  public:
+    using iterator_category = std::input_iterator_tag;
+    using value_type = std::string_view;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const std::string_view*;
+    using reference = const std::string_view&;
+
+    /** Constructs an end iterator. */
+    iterator() noexcept : reader(nullptr), current() { }
+    explicit iterator(line_reader* reader) : reader(reader), current() { ++*this; }
+
+    reference operator*() const noexcept { return current; }
+    pointer operator->() const noexcept { return &current; }
+    iterator& operator++() {
+      if (!reader->next(current)) { reader = nullptr; }
+      return *this;
+    }
+    void operator++(int) { ++*this; }
+
+    friend bool operator==(const iterator& lhs, const iterator& rhs) noexcept { return lhs.reader == rhs.reader; }
+    friend bool operator!=(const iterator& lhs, const iterator& rhs) noexcept { return lhs.reader != rhs.reader; }
+
+  private:
+    line_reader* reader;
+    std::string_view current;
+  };
+
+  /* Constructors */
+  /** Open the file at \p path. Non-empty regular files are memory mapped where possible, otherwise the file is read through a buffer of initially \p buffer_size bytes. */
+  explicit line_reader(const std::string& path, std::size_t buffer_size = default_buffer_size)
+  : map(), map_pos(0), file(nullptr), owned_file(nullptr, &std::fclose), buffer(), capacity(0), head(0), tail(0), scanned(0),
+    eof(false), lines(0) {
+#ifdef STDX_POSIX_FILES
+    struct stat info;
+    if (::stat(path.c_str(), &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0) {
+      map.open(path, true);
+      return;
+    }
+#endif
+    owned_file.reset(std::fopen(path.c_str(), "rb"));
+    if (!owned_file) { throw std::system_error(errno, std::generic_category(), "line_reader: cannot open " + path); }
+    // Avoid copying through the stdio buffer as well as our own
+    std::setvbuf(owned_file.get(), nullptr, _IONBF, 0);
+    init_stream(owned_file.get(), buffer_size);
+  }
+  /** Read from \p file, which must be open for reading and is not closed by the reader, through a buffer of initially \p buffer_size bytes. On POSIX systems the reader reads the file descriptor of \p file, so input already buffered by stdio is not seen. */
+  explicit line_reader(std::FILE* file, std::size_t buffer_size = default_buffer_size)
+  : map(), map_pos(0), file(nullptr), owned_file(nullptr, &std::fclose), buffer(), capacity(0), head(0), tail(0), scanned(0),
+    eof(false), lines(0) {
+    init_stream(file, buffer_size);
+  }
+
+  line_reader(const line_reader&) = delete;
+  line_reader& operator=(const line_reader&) = delete;
+  line_reader(line_reader&&) = default;
+  line_reader& operator=(line_reader&&) = default;
+
+  /** Read the next line into \p line. Returns false, leaving \p line unchanged, if there are no more lines. */
+  bool next(std::string_view& line) {
+    bool found = file ? next_buffered(line) : next_mapped(line);
+    if (found) {
+      if (!line.empty() && line.back() == '\r') { line.remove_suffix(1); }
+      ++lines;
+    }
+    return found;
+  }
+
+  /** Returns an iterator to the next line. Each reader can only be iterated over once. */
+  iterator begin() { return iterator(this); }
+  /** Returns the end iterator. */
+  iterator end() noexcept { return iterator(); }
+
+  /** Returns the number of lines read so far, which is the 1-based number of the last line read. */
+  std::size_t line_number() const noexcept { return lines; }
+  /** Returns true if the file is being read through a memory mapping. */
+  bool is_mapped() const noexcept { return file == nullptr; }
+
+private:
+  void init_stream(std::FILE* f, std::size_t buffer_size) {
+    file = f;
+    capacity = buffer_size > 0 ? buffer_size : default_buffer_size;
+    buffer.reset(new char[capacity]);
+  }
+
+  bool next_mapped(std::string_view& line) {
+    const std::size_t size = map.size();
+    if (map_pos >= size) { return false; }
+    const char* start = map.data() + map_pos;
+    const void* newline = std::memchr(start, '\n', size - map_pos);
+    std::size_t length = newline ? static_cast<std::size_t>(static_cast<const char*>(newline) - start) : size - map_pos;
+    line = std::string_view(start, length);
+    map_pos += length + 1;
+    return true;
+  }
+
+  bool next_buffered(std::string_view& line) {
+    for (;;) {
+      const void* newline = std::memchr(buffer.get() + scanned, '\n', tail - scanned);
+      if (newline) {
+        const char* end = static_cast<const char*>(newline);
+        line = std::string_view(buffer.get() + head, static_cast<std::size_t>(end - buffer.get()) - head);
+        head = scanned = static_cast<std::size_t>(end - buffer.get()) + 1;
+        return true;
+      }
+      scanned = tail;
+      if (eof) {
+        if (head == tail) { return false; }
+        line = std::string_view(buffer.get() + head, tail - head);
+        head = scanned = tail;
+        return true;
+      }
+      fill();
+    }
+  }
+
+  /** Read more data, moving the partial line at the end of the buffer to the front, or growing the buffer if the line fills it. */
+  void fill() {
+    if (head > 0) {
+      std::memmove(buffer.get(), buffer.get() + head, tail - head);
+      tail -= head;
+      scanned -= head;
+      head = 0;
+    }
+    if (tail == capacity) {
+      std::unique_ptr<char[]> grown(new char[capacity * 2]);
+      std::memcpy(grown.get(), buffer.get(), tail);
+      buffer = std::move(grown);
+      capacity *= 2;
+    }
+#ifdef STDX_POSIX_FILES
+    ::ssize_t count;
+    do {
+      count = ::read(fileno(file), buffer.get() + tail, capacity - tail);
+    } while (count < 0 && errno == EINTR);
+    if (count < 0) { throw std::system_error(errno, std::generic_category(), "line_reader: read failed"); }
+    if (count == 0) { eof = true; }
+    tail += static_cast<std::size_t>(count);
+#else
+    std::size_t count = std::fread(buffer.get() + tail, 1, capacity - tail, file);
+    if (count == 0) {
+      if (std::ferror(file)) { throw std::system_error(errno, std::generic_category(), "line_reader: read failed"); }
+      eof = true;
+    }
+    tail += count;
+#endif
+  }
+
+  mapped_file map;
+  std::size_t map_pos;
+  std::FILE* file;
+  std::unique_ptr<std::FILE, int (*)(std::FILE*)> owned_file;
+  std::unique_ptr<char[]> buffer;
+  std::size_t capacity, head, tail, scanned;
+  bool eof;
+  std::size_t lines;
+};
+
+/** Streaming reader splitting each line of a file into fields.
+
+ Lines are read with a line_reader, and split into fields with the same rules as basic_string::split. Fields are string views into the line, and are valid until the next call to next. Optionally each field has leading and trailing whitespace stripped, as basic_string::strip.
+ */
+class field_reader {
+public:
+  /* Constructors */
+  /** Read lines from \p lines, splitting at \p separator_char. If \p separator_char is negative, splits at whitespace. */
+  explicit field_reader(line_reader&& lines, char separator_char = -1, bool treat_consecutive_as_one = true, bool strip_each = false)
+  : reader(std::move(lines)), current(), separators(nullptr), separator(separator_char),
+    merge(treat_consecutive_as_one), strip_fields(strip_each) { }
+  /** Read lines from \p lines, splitting at any of the characters in \p separator_class, which must outlive the reader. */
+  field_reader(line_reader&& lines, const char_class& separator_class, bool treat_consecutive_as_one = true, bool strip_each = false)
+  : reader(std::move(lines)), current(), separators(&separator_class), separator(),
+    merge(treat_consecutive_as_one), strip_fields(strip_each) { }
+  field_reader(line_reader&&, const char_class&&, bool = true, bool = false) = delete;
+  /** Read the file at \p path, splitting at \p separator_char. If \p separator_char is negative, splits at whitespace. */
+  explicit field_reader(const std::string& path, char separator_char = -1, bool treat_consecutive_as_one = true, bool strip_each = false)
+  : field_reader(line_reader(path), separator_char, treat_consecutive_as_one, strip_each) { }
+  /** Read the file at \p path, splitting at any of the characters in \p separator_class, which must outlive the reader. */
+  field_reader(const std::string& path, const char_class& separator_class, bool treat_consecutive_as_one = true, bool strip_each = false)
+  : field_reader(line_reader(path), separator_class, treat_consecutive_as_one, strip_each) { }
+  field_reader(const std::string&, const char_class&&, bool = true, bool = false) = delete;
+
+  /** Read the next line, replacing the contents of \p fields with its fields. Returns false, leaving \p fields unchanged, if there are no more lines. */
+  bool next(std::vector<std::string_view>& fields) {
+    if (!reader.next(current)) { return false; }
+    fields.clear();
+    split_view tokens = separators ? split_view(current, *separators, merge) : split_view(current, separator, merge);
+    for (std::string_view field : tokens) { fields.push_back(strip_fields ? stdx::strip(field) : field); }
+    return true;
+  }
+
+  /** Returns the last line read. */
+  std::string_view line() const noexcept { return current; }
+  /** Returns the number of lines read so far, which is the 1-based number of the last line read. */
+  std::size_t line_number() const noexcept { return reader.line_number(); }
+
+private:
+  line_reader reader;
+  std::string_view current;
+  const char_class* separators; // Separator class, or null to split at separator
+  char separator;
+  bool merge;
+  bool strip_fields;
+};
+
+}
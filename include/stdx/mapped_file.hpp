@@ -0,0 +1,129 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define STDX_POSIX_FILES 1
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#include <fstream>
+#include <memory>
+#endif
+
+namespace stdx {
+
+/** Read-only view of the contents of a file.
+
+ On POSIX systems the file is memory mapped, so pages are only read from disk as they are accessed and are shared between all processes mapping the same file. On other systems the contents are read into memory.
+
+ Errors are reported by throwing std::system_error.
+ */
+class mapped_file {
+public:
+  /** Default constructor.
+   *  Constructs an object that does not refer to any file.
+   */
+  mapped_file() noexcept : ptr(nullptr), length(0) { }
+
+  /** Map the file at \p path. If \p sequential is true, the system is advised that the file will be read from start to end. */
+  explicit mapped_file(const std::string& path, bool sequential = false) : mapped_file() { open(path, sequential); }
+
+  mapped_file(const mapped_file&) = delete;
+  mapped_file& operator=(const mapped_file&) = delete;
+
+  /** Move constructor. \p other no longer refers to a file afterwards. */
+  mapped_file(mapped_file&& other) noexcept : mapped_file() { swap(other); }
+  mapped_file& operator=(mapped_file&& other) noexcept {
+    if (&other != this) {
+      close();
+      swap(other);
+    }
+    return *this;
+  }
+
+  /** Destructor. Unmaps the file. */
+  ~mapped_file() { close(); }
+
+  /** Map the file at \p path, unmapping any file currently mapped. */
+  void open(const std::string& path, bool sequential = false) {
+    close();
+#ifdef STDX_POSIX_FILES
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) { throw std::system_error(errno, std::generic_category(), "mapped_file: cannot open " + path); }
+    struct stat info;
+    if (::fstat(fd, &info) != 0) {
+      int error = errno;
+      ::close(fd);
+      throw std::system_error(error, std::generic_category(), "mapped_file: cannot stat " + path);
+    }
+    if (info.st_size > 0) {
+      void* mapping = ::mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ, MAP_SHARED, fd, 0);
+      if (mapping == MAP_FAILED) {
+        int error = errno;
+        ::close(fd);
+        throw std::system_error(error, std::generic_category(), "mapped_file: cannot map " + path);
+      }
+      ptr = static_cast<const char*>(mapping);
+      length = static_cast<std::size_t>(info.st_size);
+      if (sequential) { ::madvise(mapping, length, MADV_SEQUENTIAL); }
+    }
+    ::close(fd);
+#else
+    (void)sequential;
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in) { throw std::system_error(std::make_error_code(std::errc::no_such_file_or_directory), "mapped_file: cannot open " + path); }
+    length = static_cast<std::size_t>(in.tellg());
+    buffer.reset(new char[length == 0 ? 1 : length]);
+    in.seekg(0);
+    if (!in.read(buffer.get(), static_cast<std::streamsize>(length))) {
+      throw std::system_error(std::make_error_code(std::errc::io_error), "mapped_file: cannot read " + path);
+    }
+    ptr = buffer.get();
+#endif
+  }
+
+  /** Unmap the file. */
+  void close() noexcept {
+#ifdef STDX_POSIX_FILES
+    if (ptr) { ::munmap(const_cast<char*>(ptr), length); }
+#else
+    buffer.reset();
+#endif
+    ptr = nullptr;
+    length = 0;
+  }
+
+  /** Returns a pointer to the start of the file contents. Null if no file, or an empty file, is mapped. */
+  const char* data() const noexcept { return ptr; }
+  /** Returns the size of the file in bytes. */
+  std::size_t size() const noexcept { return length; }
+  /** Returns true if the file is empty or no file is mapped. */
+  bool empty() const noexcept { return length == 0; }
+  /** Returns the file contents as a string view. */
+  std::string_view view() const noexcept { return std::string_view(ptr, length); }
+
+  void swap(mapped_file& other) noexcept {
+    std::swap(ptr, other.ptr);
+    std::swap(length, other.length);
+#ifndef STDX_POSIX_FILES
+    std::swap(buffer, other.buffer);
+#endif
+  }
+
+private:
+  const char* ptr;
+  std::size_t length;
+#ifndef STDX_POSIX_FILES
+  std::unique_ptr<char[]> buffer;
+#endif
+};
+
+}
@@ -0,0 +1,289 @@
+#pragma once
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+#include "common.hpp"
+#include "fixed_vector.hpp"
+#include "mapped_file.hpp"
+
+namespace stdx {
+
+/** Header of the binary format written by save. The elements follow immediately, in the byte order of the machine that wrote them, starting at a multiple of 64 bytes from the start of the file. */
+struct fixed_vector_file_header {
+  static constexpr char magic_value[8] = {'S', 'T', 'D', 'X', 'F', 'V', 'E', 'C'};
+  static constexpr uint32_t current_version = 1;
+  static constexpr uint32_t byte_order_mark = 0x01020304;
+
+  char magic[8];
+  uint32_t version;
+  uint32_t byte_order;   // byte_order_mark as written, which reads differently on a machine of the other byte order
+  int64_t min_index;
+  int64_t max_index;
+  uint64_t count;        // Number of elements. Zero for an empty fixed_vector, which has min_index == max_index, or max_index == min_index - 1.
+  uint64_t element_size;
+  uint64_t element_align;
+  uint64_t checksum;     // fixed_vector_checksum of the element bytes
+};
+static_assert(sizeof(fixed_vector_file_header) == 64, "The elements must start 64 bytes into the file");
+
+/** Returns the checksum stored in the header of saved fixed_vectors, of the \p n bytes at \p data. */
+inline uint64_t fixed_vector_checksum(const void* data, std::size_t n) noexcept {
+  return detail::hash_bytes(data, n, [](uint64_t w) { return w; });
+}
+
+namespace detail {
+
+/** Returns the header describing \p v in a saved file. */
+template <class T, class Allocator>
+fixed_vector_file_header fixed_vector_header(const fixed_vector<T, Allocator>& v) noexcept {
+  static_assert(std::is_trivially_copyable_v<T>, "Only fixed_vectors of trivially copyable types can be saved");
+  fixed_vector_file_header header;
+  std::memcpy(header.magic, fixed_vector_file_header::magic_value, sizeof(header.magic));
+  header.version = fixed_vector_file_header::current_version;
+  header.byte_order = fixed_vector_file_header::byte_order_mark;
+  header.min_index = v.min_index();
+  header.max_index = v.max_index();
+  header.count = v.size();
+  header.element_size = sizeof(T);
+  header.element_align = alignof(T);
+  header.checksum = fixed_vector_checksum(v.data(), v.size() * sizeof(T));
+  return header;
+}
+
+#ifdef STDX_POSIX_FILES
+/** Write the \p n bytes at \p data to \p fd, retrying short writes. Returns false, leaving the error in errno, if writing fails. */
+inline bool write_all(int fd, const void* data, std::size_t n) noexcept {
+  const char* bytes = static_cast<const char*>(data);
+  while (n > 0) {
+    const ::ssize_t written = ::write(fd, bytes, n);
+    if (written < 0) {
+      if (errno == EINTR) { continue; }
+      return false;
+    }
+    bytes += written;
+    n -= static_cast<std::size_t>(written);
+  }
+  return true;
+}
+#endif
+
+}
+
+/** Write \p v to \p out in the binary format read by mapped_fixed_vector. If writing fails, an exception of type std::system_error is thrown. */
+template <class T, class Allocator>
+void save(const fixed_vector<T, Allocator>& v, std::ostream& out) {
+  const fixed_vector_file_header header = detail::fixed_vector_header(v);
+  out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  out.write(reinterpret_cast<const char*>(v.data()), static_cast<std::streamsize>(v.size() * sizeof(T)));
+  if (!out) { throw std::system_error(std::make_error_code(std::errc::io_error), "save: cannot write fixed_vector"); }
+}
+/** Write \p v to the file at \p path in the binary format read by mapped_fixed_vector.
+ *  The file is written under a unique temporary name in the same directory, flushed to disk, and renamed over \p path, so processes which have the old file mapped keep a consistent copy, concurrent saves to the same path do not interfere, and after a crash \p path holds either the old or the new contents. On POSIX systems the new file has permissions 0644. Elsewhere the temporary is \p path with ".tmp" appended and is not flushed before the rename. If writing fails, an exception of type std::system_error is thrown and \p path is unchanged.
+ */
+template <class T, class Allocator>
+void save(const fixed_vector<T, Allocator>& v, const std::string& path) {
+#ifdef STDX_POSIX_FILES
+  const fixed_vector_file_header header = detail::fixed_vector_header(v);
+  std::string temporary = path + ".XXXXXX";
+  const int fd = ::mkstemp(&temporary[0]);
+  if (fd < 0) { throw std::system_error(errno, std::generic_category(), "save: cannot create a temporary file for " + path); }
+  const bool written = ::fchmod(fd, 0644) == 0 && detail::write_all(fd, &header, sizeof(header))
+                       && detail::write_all(fd, v.data(), v.size() * sizeof(T)) && ::fsync(fd) == 0;
+  const int error = errno;
+  if (::close(fd) != 0 || !written) {
+    ::unlink(temporary.c_str());
+    throw std::system_error(written ? errno : error, std::generic_category(), "save: cannot write " + temporary);
+  }
+  if (::rename(temporary.c_str(), path.c_str()) != 0) {
+    const int rename_error = errno;
+    ::unlink(temporary.c_str());
+    throw std::system_error(rename_error, std::generic_category(), "save: cannot rename " + temporary + " to " + path);
+  }
+  // Make the rename itself durable. Failure here leaves a complete file at path, so is not reported.
+  const std::string::size_type slash = path.rfind('/');
+  const std::string directory = slash == std::string::npos ? "." : (slash == 0 ? "/" : path.substr(0, slash));
+  const int dir = ::open(directory.c_str(), O_RDONLY);
+  if (dir >= 0) {
+    ::fsync(dir);
+    ::close(dir);
+  }
+#else
+  const std::string temporary = path + ".tmp";
+  {
+    std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+    if (!out) { throw std::system_error(std::make_error_code(std::errc::io_error), "save: cannot open " + temporary); }
+    try {
+      save(v, out);
+      out.close();
+      if (!out) { throw std::system_error(std::make_error_code(std::errc::io_error), "save: cannot write " + temporary); }
+    } catch (...) {
+      out.close();
+      std::remove(temporary.c_str());
+      throw;
+    }
+  }
+  if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+    const int error = errno;
+    std::remove(temporary.c_str());
+    throw std::system_error(error, std::generic_category(), "save: cannot rename " + temporary + " to " + path);
+  }
+#endif
+}
+
+/** Read-only fixed vector served directly from a file written by save.
+
+ The file is memory mapped, and elements are read from the mapping without being copied, so opening a table costs the same whatever its size, pages are only read from disk as they are used, and all processes mapping the same file share one copy in the page cache. Indexing is the same as the fixed_vector that was saved.
+
+ Opening checks the header: the magic number, version, byte order, element size and alignment, and that the file holds exactly the elements the bounds describe. Checking the checksum reads the whole file, so is done only when requested. A file in the wrong format causes an exception of type std::runtime_error, and failure to read it one of type std::system_error.
+
+ \tparam T element type. Must be trivially copyable, and be the same type, compiled for the same platform, as the saved elements.
+ */
+template <class T>
+class mapped_fixed_vector {
+  static_assert(std::is_trivially_copyable_v<T>, "mapped_fixed_vector requires a trivially copyable type");
+  static_assert(alignof(T) <= sizeof(fixed_vector_file_header), "Elements would not be aligned in the mapping");
+public:
+  /* Member types */
+  using value_type = T;
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+  using reference = const T&;
+  using const_reference = const T&;
+  using pointer = const T*;
+  using const_pointer = const T*;
+  using iterator = const T*;
+  using const_iterator = const T*;
+
+  /* Constructors */
+  /** Default constructor.
+   *  Constructs an object that does not refer to any file.
+   */
+  mapped_fixed_vector() noexcept : file(), elems(nullptr), count(0), minindex(0), maxindex(0), stored_checksum(0) { }
+  /** Map the file at \p path. If \p verify_checksum is true, the checksum of the elements is also checked, which reads the whole file. */
+  explicit mapped_fixed_vector(const std::string& path, bool verify_checksum = false) : mapped_fixed_vector() { open(path, verify_checksum); }
+
+  mapped_fixed_vector(mapped_fixed_vector&& other) noexcept : mapped_fixed_vector() { swap(other); }
+  mapped_fixed_vector& operator=(mapped_fixed_vector&& other) noexcept {
+    if (&other != this) {
+      close();
+      swap(other);
+    }
+    return *this;
+  }
+
+  /** Map the file at \p path, unmapping any file currently mapped. */
+  void open(const std::string& path, bool verify_checksum = false) {
+    close();
+    mapped_file mapping(path);
+    fixed_vector_file_header header;
+    if (mapping.size() < sizeof(header)) { throw std::runtime_error("mapped_fixed_vector: " + path + " is too short"); }
+    std::memcpy(&header, mapping.data(), sizeof(header));
+    if (std::memcmp(header.magic, fixed_vector_file_header::magic_value, sizeof(header.magic)) != 0) {
+      throw std::runtime_error("mapped_fixed_vector: " + path + " is not a saved fixed_vector");
+    }
+    if (header.version != fixed_vector_file_header::current_version) { throw std::runtime_error("mapped_fixed_vector: " + path + " has an unsupported version"); }
+    if (header.byte_order != fixed_vector_file_header::byte_order_mark) { throw std::runtime_error("mapped_fixed_vector: " + path + " has the wrong byte order"); }
+    if (header.element_size != sizeof(T) || header.element_align != alignof(T)) {
+      throw std::runtime_error("mapped_fixed_vector: " + path + " holds elements of a different type");
+    }
+    const uint64_t payload = mapping.size() - sizeof(header);
+    // Differences are taken in uint64_t, which cannot overflow once the order of the bounds is known. An empty fixed_vector has min_index == max_index
+    // if default constructed, or max_index == min_index - 1 if built from an empty range.
+    const uint64_t lo = static_cast<uint64_t>(header.min_index), hi = static_cast<uint64_t>(header.max_index);
+    const bool consistent = header.count == 0 ? (header.min_index == header.max_index || (header.max_index < header.min_index && lo - hi == 1))
+                                              : (header.max_index >= header.min_index && hi - lo == header.count - 1);
+    if (payload / sizeof(T) != header.count || payload % sizeof(T) != 0 || !consistent) {
+      throw std::runtime_error("mapped_fixed_vector: " + path + " has inconsistent bounds");
+    }
+    const char* first = mapping.data() + sizeof(header);
+    if (reinterpret_cast<std::uintptr_t>(first) % alignof(T) != 0) { throw std::runtime_error("mapped_fixed_vector: " + path + " is not aligned in memory"); }
+    if (verify_checksum && fixed_vector_checksum(first, static_cast<std::size_t>(payload)) != header.checksum) {
+      throw std::runtime_error("mapped_fixed_vector: " + path + " failed its checksum");
+    }
+    file = std::move(mapping);
+    elems = reinterpret_cast<const T*>(first);
+    count = static_cast<size_type>(header.count);
+    minindex = header.min_index;
+    maxindex = header.max_index;
+    stored_checksum = header.checksum;
+  }
+  /** Unmap the file. */
+  void close() noexcept {
+    file.close();
+    elems = nullptr;
+    count = 0;
+    minindex = maxindex = 0;
+    stored_checksum = 0;
+  }
+
+  /** Returns true if the checksum of the elements matches the one saved in the header. Reads the whole file. */
+  bool verify() const noexcept { return fixed_vector_checksum(elems, count * sizeof(T)) == stored_checksum; }
+
+  /** Return a reference to the element at specified location \p pos, with bounds checking. If \p pos is not within the range of the container, an exception of type std::out_of_range is thrown. */
+  const_reference at(int64_t pos) const {
+    if (count == 0 || pos < minindex || pos > maxindex) { throw std::out_of_range("mapped_fixed_vector::at"); }
+    return elems[pos - minindex];
+  }
+  /** Returns a reference to the element at specified location pos. No bounds checking is performed. */
+  const_reference operator[](int64_t pos) const noexcept { return elems[pos - minindex]; }
+
+  /** Returns a reference to the first element. Calling front on an empty container is undefined. */
+  const_reference front() const noexcept { return elems[0]; }
+  /** Returns a reference to the last element. Calling back on an empty container is undefined. */
+  const_reference back() const noexcept { return elems[count - 1]; }
+  /** Returns a pointer to the elements in the mapping. */
+  const T* data() const noexcept { return elems; }
+
+  /** Iterators over the elements, from the minimum index. */
+  const_iterator begin() const noexcept { return elems; }
+  const_iterator cbegin() const noexcept { return elems; }
+  const_iterator end() const noexcept { return elems + count; }
+  const_iterator cend() const noexcept { return elems + count; }
+
+  /** Returns the number of elements. */
+  size_type size() const noexcept { return count; }
+  /** Returns true if there are no elements. */
+  bool empty() const noexcept { return count == 0; }
+  /** Returns the minimum index. */
+  int64_t min_index() const noexcept { return minindex; }
+  /** Returns the maximum index. */
+  int64_t max_index() const noexcept { return maxindex; }
+
+  /** Returns a copy of the elements in a fixed_vector, for when they need to be modified. */
+  template <class Allocator = std::allocator<T>>
+  fixed_vector<T, Allocator> to_fixed_vector(const Allocator& alloc = Allocator()) const {
+    if (count == 0) { return fixed_vector<T, Allocator>(alloc); }
+    return fixed_vector<T, Allocator>(minindex, begin(), end(), alloc);
+  }
+
+  void swap(mapped_fixed_vector& other) noexcept {
+    file.swap(other.file);
+    std::swap(elems, other.elems);
+    std::swap(count, other.count);
+    std::swap(minindex, other.minindex);
+    std::swap(maxindex, other.maxindex);
+    std::swap(stored_checksum, other.stored_checksum);
+  }
+
+private:
+  mapped_file file;
+  const T* elems;
+  size_type count;
+  int64_t minindex, maxindex;
+  uint64_t stored_checksum;
+};
+
+}
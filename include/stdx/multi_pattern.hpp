@@ -0,0 +1,210 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "char_class.hpp"
+
+namespace stdx {
+
+/** Position of a match in a text, and the index of the matching pattern. */
+struct pattern_match {
+  std::size_t pos;
+  std::size_t length;
+  std::size_t pattern;
+
+  /** Returns true if a match was found. */
+  explicit operator bool() const noexcept { return pos != static_cast<std::size_t>(-1); }
+};
+
+/** Precompiled set of patterns, searched for together in a single pass over the text.
+
+ The patterns are compiled into an Aho-Corasick automaton, with transitions stored as a dense table over the characters that occur in the patterns, so each character of the text costs one table lookup, regardless of the number of patterns. Between candidate matches, the text is skipped with a search for the first characters of the patterns, which uses SIMD kernels for single byte character types. For wider character types, code units of 256 or above are looked up by binary search.
+
+ Matches are reported leftmost first, and when several patterns match at the same position the longest is chosen. Successive matches do not overlap, as with Python's str.count and str.replace.
+
+ \tparam CharT character type.
+ \tparam Traits traits class specifying the operations on the character type
+ */
+template <class CharT, class Traits = std::char_traits<CharT>>
+class basic_multi_pattern {
+  using unsigned_type = std::make_unsigned_t<CharT>;
+
+public:
+  /* Member types */
+  using view_type = std::basic_string_view<CharT, Traits>;
+  using size_type = std::size_t;
+
+  /* Static constants */
+  static constexpr size_type npos = static_cast<size_type>(-1);
+
+  using match = pattern_match;
+
+  /* Constructors */
+  /** Construct the set from the patterns in the range [\p first, \p last). Patterns are numbered in order from zero. If any pattern is empty, an exception of type std::invalid_argument is thrown. */
+  template <class InputIt>
+  basic_multi_pattern(InputIt first, InputIt last) {
+    for (; first != last; ++first) {
+      const view_type pattern(*first);
+      if (pattern.empty()) { throw std::invalid_argument("Empty pattern."); }
+      patterns.emplace_back(pattern);
+    }
+    build();
+  }
+  /** Construct the set from the patterns in \p init. */
+  basic_multi_pattern(std::initializer_list<view_type> init) : basic_multi_pattern(init.begin(), init.end()) { }
+
+  /** Returns the number of patterns. */
+  size_type size() const noexcept { return patterns.size(); }
+  /** Returns the pattern numbered \p index. */
+  view_type pattern(size_type index) const noexcept { return patterns[index]; }
+
+  /** Find the first match in \p text starting at or after \p pos. If there is no match, the returned match has pos == npos. */
+  match find(view_type text, size_type pos = 0) const noexcept {
+    match best{npos, 0, 0};
+    const size_type n = text.size();
+    uint32_t state = 0;
+    for (size_type i = pos; i < n;) {
+      if (state == 0) {
+        if (best.pos != npos) { break; }
+        if (prefilter) {
+          i = first_chars.find_first_of(text.data(), n, i);
+          if (i == npos) { break; }
+        }
+      }
+      state = transitions[state * classes + class_of(text[i])];
+      ++i;
+      // Any later match starts at or after the longest pattern prefix ending here
+      if (best.pos != npos && i - depth[state] > best.pos) { break; }
+      const int32_t found = output[state];
+      if (found >= 0) {
+        const size_type length = patterns[static_cast<size_type>(found)].size();
+        const size_type start = i - length;
+        if (best.pos == npos || start < best.pos || (start == best.pos && length > best.length)) {
+          best = match{start, length, static_cast<size_type>(found)};
+        }
+      }
+    }
+    return best;
+  }
+
+  /** Call \p f(match) for each successive non-overlapping match in \p text. */
+  template <class F>
+  void for_each_match(view_type text, F f) const {
+    for (match m = find(text); m; m = find(text, m.pos + m.length)) { f(m); }
+  }
+
+  /** Returns the number of non-overlapping matches in \p text. */
+  size_type count(view_type text) const noexcept {
+    size_type result = 0;
+    for (match m = find(text); m; m = find(text, m.pos + m.length)) { ++result; }
+    return result;
+  }
+
+private:
+  void build() {
+    // Number the characters used by the patterns, with class 0 for all others
+    classes = 1;
+    for (uint32_t& c : byte_classes) { c = 0; }
+    std::vector<unsigned_type> wide;
+    for (const auto& pattern : patterns) {
+      for (CharT ch : pattern) {
+        const unsigned_type u = static_cast<unsigned_type>(ch);
+        if (u >= 256) { wide.push_back(u); }
+        else if (byte_classes[u] == 0) { byte_classes[u] = static_cast<uint32_t>(classes++); }
+      }
+    }
+    std::sort(wide.begin(), wide.end());
+    wide.erase(std::unique(wide.begin(), wide.end()), wide.end());
+    wide_units = wide;
+    for (std::size_t i = 0; i < wide_units.size(); ++i) { wide_classes.push_back(static_cast<uint32_t>(classes++)); }
+    // The prefilter is skipped if the first characters do not fit in a character class
+    prefilter = true;
+    std::size_t first_wide = 0;
+    for (const auto& pattern : patterns) {
+      if (first_chars.contains(pattern.front())) { continue; }
+      if (static_cast<unsigned_type>(pattern.front()) >= 256 && ++first_wide > basic_char_class<CharT>::max_extended) { prefilter = false; break; }
+      first_chars.insert(pattern.front());
+    }
+
+    // Trie of the patterns
+    transitions.assign(classes, -1);
+    depth.assign(1, 0);
+    output.assign(1, -1);
+    for (size_type p = 0; p < patterns.size(); ++p) {
+      size_type state = 0;
+      for (CharT ch : patterns[p]) {
+        int32_t& next = transitions[state * classes + class_of(ch)];
+        if (next < 0) {
+          next = static_cast<int32_t>(depth.size());
+          depth.push_back(depth[state] + 1);
+          output.push_back(-1);
+          transitions.resize(transitions.size() + classes, -1);
+        }
+        state = static_cast<size_type>(transitions[state * classes + class_of(ch)]);
+      }
+      if (output[state] < 0) { output[state] = static_cast<int32_t>(p); }
+    }
+
+    // Breadth first, fill in missing transitions from the failure state, the longest proper suffix which is also in the trie
+    std::vector<uint32_t> fail(depth.size(), 0), queue;
+    queue.reserve(depth.size());
+    for (size_type c = 0; c < classes; ++c) {
+      int32_t& next = transitions[c];
+      if (next < 0) { next = 0; }
+      else { queue.push_back(static_cast<uint32_t>(next)); }
+    }
+    for (size_type q = 0; q < queue.size(); ++q) {
+      const uint32_t state = queue[q];
+      if (output[state] < 0) { output[state] = output[fail[state]]; }
+      for (size_type c = 0; c < classes; ++c) {
+        int32_t& next = transitions[state * classes + c];
+        const int32_t fallback = transitions[fail[state] * classes + c];
+        if (next < 0) {
+          next = fallback;
+        } else {
+          fail[static_cast<size_type>(next)] = static_cast<uint32_t>(fallback);
+          queue.push_back(static_cast<uint32_t>(next));
+        }
+      }
+    }
+  }
+
+  /** Returns the number of the character class of \p ch, which is zero for characters not used by any pattern. */
+  uint32_t class_of(CharT ch) const noexcept {
+    const unsigned_type u = static_cast<unsigned_type>(ch);
+    if (u < 256) { return byte_classes[u]; }
+    if constexpr (sizeof(CharT) == 1) {
+      return 0;
+    } else {
+      auto it = std::lower_bound(wide_units.begin(), wide_units.end(), u);
+      return (it != wide_units.end() && *it == u) ? wide_classes[static_cast<std::size_t>(it - wide_units.begin())] : 0;
+    }
+  }
+
+  std::vector<std::basic_string<CharT, Traits>> patterns;
+  basic_char_class<CharT> first_chars;
+  bool prefilter;
+  uint32_t byte_classes[256];
+  std::vector<unsigned_type> wide_units;  // Sorted code units of 256 or above used by the patterns
+  std::vector<uint32_t> wide_classes;
+  size_type classes;
+  std::vector<int32_t> transitions;  // State * classes + character class
+  std::vector<uint32_t> depth;       // Length of the prefix each state represents
+  std::vector<int32_t> output;       // Longest pattern which is a suffix of the state's prefix, or -1
+};
+
+/** Typedefs for common character types **/
+using multi_pattern = basic_multi_pattern<char>;
+using wmulti_pattern = basic_multi_pattern<wchar_t>;
+using u16multi_pattern = basic_multi_pattern<char16_t>;
+using u32multi_pattern = basic_multi_pattern<char32_t>;
+
+}
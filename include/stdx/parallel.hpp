@@ -0,0 +1,252 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <numeric>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "common.hpp"
+#include "fixed_vector.hpp"
+
+namespace stdx {
+
+/** Pool of worker threads for running parallel loops.
+
+ A loop is split into chunks, which the workers and the calling thread claim one at a time from a shared counter until none are left, so threads that finish early take over the remaining work. Loops started from inside a running loop are run serially on the calling thread, and loops started concurrently from different threads are run one after another.
+ */
+class thread_pool {
+public:
+  /* Constructors */
+  /** Construct a pool running loops on \p threads threads in total, including the calling thread. Defaults to the number of hardware threads. */
+  explicit thread_pool(unsigned threads = 0) : current(nullptr), generation(0), stopping(false) {
+    unsigned count = threads ? threads : std::max(1u, std::thread::hardware_concurrency());
+    workers.reserve(count - 1);
+    for (unsigned i = 1; i < count; ++i) { workers.emplace_back([this] { worker_loop(); }); }
+  }
+
+  thread_pool(const thread_pool&) = delete;
+  thread_pool& operator=(const thread_pool&) = delete;
+
+  /** Destructor. Waits for the workers to exit. */
+  ~thread_pool() {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      stopping = true;
+    }
+    wake.notify_all();
+    for (std::thread& worker : workers) { worker.join(); }
+  }
+
+  /** Returns the pool shared by the parallel algorithms by default, which uses all hardware threads. */
+  static thread_pool& default_instance() {
+    static thread_pool pool;
+    return pool;
+  }
+
+  /** Returns the number of threads running loops, including the calling thread. */
+  unsigned concurrency() const noexcept { return static_cast<unsigned>(workers.size()) + 1; }
+
+  /** Call \p body(i) for each i in [0, \p count), in parallel, and wait for all calls to finish. If any call throws, remaining chunks are skipped and the first exception is rethrown. */
+  template <class F>
+  void run(std::size_t count, F&& body) {
+    if (count == 0) { return; }
+    if (workers.empty() || count == 1 || active_job() != nullptr) {
+      for (std::size_t i = 0; i < count; ++i) { body(i); }
+      return;
+    }
+    std::lock_guard<std::mutex> serial(run_mutex);
+    using body_type = std::remove_reference_t<F>;
+    job task(count, &body, [](void* context, std::size_t i) { (*static_cast<body_type*>(context))(i); });
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      current = &task;
+      ++generation;
+    }
+    wake.notify_all();
+    execute(task);
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      done.wait(lock, [&] { return task.active == 0; });
+      current = nullptr;
+    }
+    if (task.error) { std::rethrow_exception(task.error); }
+  }
+
+private:
+  struct job {
+    job(std::size_t count, void* context, void (*invoke)(void*, std::size_t))
+    : next(0), count(count), context(context), invoke(invoke), active(0), error() { }
+    std::atomic<std::size_t> next;
+    std::size_t count;
+    void* context;
+    void (*invoke)(void*, std::size_t);
+    unsigned active;  // Workers executing the job, guarded by mutex
+    std::exception_ptr error;
+    std::mutex error_mutex;
+  };
+
+  static job*& active_job() noexcept {
+    static thread_local job* running = nullptr;
+    return running;
+  }
+
+  static void execute(job& task) {
+    active_job() = &task;
+    for (;;) {
+      std::size_t i = task.next.fetch_add(1, std::memory_order_relaxed);
+      if (i >= task.count) { break; }
+      try {
+        task.invoke(task.context, i);
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(task.error_mutex);
+        if (!task.error) { task.error = std::current_exception(); }
+        task.next.store(task.count, std::memory_order_relaxed);
+      }
+    }
+    active_job() = nullptr;
+  }
+
+  void worker_loop() {
+    uint64_t seen = 0;
+    std::unique_lock<std::mutex> lock(mutex);
+    for (;;) {
+      wake.wait(lock, [&] { return stopping || (current != nullptr && generation != seen); });
+      if (stopping) { return; }
+      seen = generation;
+      job& task = *current;
+      ++task.active;
+      lock.unlock();
+      execute(task);
+      lock.lock();
+      if (--task.active == 0) { done.notify_all(); }
+    }
+  }
+
+  std::vector<std::thread> workers;
+  std::mutex mutex, run_mutex;
+  std::condition_variable wake, done;
+  job* current;
+  uint64_t generation;
+  bool stopping;
+};
+
+namespace detail {
+
+/** Division of [0, size) into chunks whose boundaries fall on cache line boundaries of the element storage, so that no two chunks write to the same cache line.
+
+ Element starts fall on cache line boundaries every lcm(cache_line, sizeof(T)) bytes, so chunks are multiples of that many bytes, after a head chunk reaching the first element starting on a cache line. If no element starts on a cache line, which can only happen when the storage is not aligned to gcd(cache_line, sizeof(T)) bytes, chunks remain multiples of the period but neighbouring chunks may share a line.
+ */
+class cache_line_chunks {
+public:
+  template <class T>
+  cache_line_chunks(const T* data, std::size_t size, unsigned threads) : size(size), head(0), chunk(1) {
+    // Number of elements between elements starting on a cache line, lcm(cache_line, sizeof(T)) / sizeof(T)
+    const std::size_t period = cache_line / std::gcd(cache_line, sizeof(T));
+    const std::uintptr_t address = reinterpret_cast<std::uintptr_t>(data);
+    for (std::size_t i = 0; i < period; ++i) {
+      if ((address + i * sizeof(T)) % cache_line == 0) {
+        head = std::min(size, i);
+        break;
+      }
+    }
+    // Several chunks per thread, so threads that finish early can take over work
+    const std::size_t target = std::max<std::size_t>(1, size / (std::size_t(threads) * 8));
+    chunk = (target + period - 1) / period * period;
+  }
+
+  /** Returns the number of chunks. */
+  std::size_t count() const noexcept { return (head > 0 ? 1 : 0) + (size - head + chunk - 1) / chunk; }
+  /** Returns the offsets [first, last) of chunk \p i. */
+  std::pair<std::size_t, std::size_t> bounds(std::size_t i) const noexcept {
+    if (head > 0) {
+      if (i == 0) { return {0, head}; }
+      --i;
+    }
+    const std::size_t first = head + i * chunk;
+    return {first, std::min(size, first + chunk)};
+  }
+
+private:
+  std::size_t size, head, chunk;
+};
+
+}
+
+/** Call \p f(index, element) for every element of \p v, in parallel, where index is the logical index of the element in [min_index, max_index].
+ *  Elements are split into chunks aligned to cache lines and run on \p pool. Calls for different elements may run concurrently, so \p f must not modify shared state without synchronisation.
+ */
+template <class T, class Allocator, class F>
+void parallel_for_indexed(fixed_vector<T, Allocator>& v, F&& f, thread_pool& pool = thread_pool::default_instance()) {
+  T* data = v.data();
+  const int64_t min = v.min_index();
+  detail::cache_line_chunks chunks(data, v.size(), pool.concurrency());
+  pool.run(chunks.count(), [&](std::size_t c) {
+    auto [first, last] = chunks.bounds(c);
+    for (std::size_t i = first; i < last; ++i) { f(min + static_cast<int64_t>(i), data[i]); }
+  });
+}
+template <class T, class Allocator, class F>
+void parallel_for_indexed(const fixed_vector<T, Allocator>& v, F&& f, thread_pool& pool = thread_pool::default_instance()) {
+  const T* data = v.data();
+  const int64_t min = v.min_index();
+  detail::cache_line_chunks chunks(data, v.size(), pool.concurrency());
+  pool.run(chunks.count(), [&](std::size_t c) {
+    auto [first, last] = chunks.bounds(c);
+    for (std::size_t i = first; i < last; ++i) { f(min + static_cast<int64_t>(i), data[i]); }
+  });
+}
+
+/** Set out[index] = \p f(index, in[index]) for every index of \p in, in parallel.
+ *  \p out is resized to the bounds of \p in if they differ, so U must be default constructible as well as assignable from the result of \p f. Chunk boundaries are placed on the cache lines of \p out, so no two threads write to the same cache line, whenever elements of \p out start on cache lines (see detail::cache_line_chunks).
+ */
+template <class T, class AllocatorIn, class U, class AllocatorOut, class F>
+void transform_indexed(const fixed_vector<T, AllocatorIn>& in, fixed_vector<U, AllocatorOut>& out, F&& f,
+                       thread_pool& pool = thread_pool::default_instance()) {
+  if (in.size() == 0) {
+    out = fixed_vector<U, AllocatorOut>(out.get_allocator());
+    return;
+  }
+  if (out.min_index() != in.min_index() || out.max_index() != in.max_index() || out.size() != in.size()) {
+    out.resize(in.min_index(), in.max_index());
+  }
+  const T* source = in.data();
+  U* destination = out.data();
+  const int64_t min = in.min_index();
+  detail::cache_line_chunks chunks(destination, in.size(), pool.concurrency());
+  pool.run(chunks.count(), [&](std::size_t c) {
+    auto [first, last] = chunks.bounds(c);
+    for (std::size_t i = first; i < last; ++i) { destination[i] = f(min + static_cast<int64_t>(i), source[i]); }
+  });
+}
+
+/** Reduce \p map(index, element) over every element of \p v, in parallel, combining values with \p reduce and starting from \p init.
+ *  Each chunk is reduced separately, and the partial results are then combined in index order, so the result is deterministic for a given pool size. \p reduce must be associative. R need not be default constructible.
+ */
+template <class T, class Allocator, class R, class Reduce, class Map>
+R reduce_indexed(const fixed_vector<T, Allocator>& v, R init, Reduce reduce, Map map, thread_pool& pool = thread_pool::default_instance()) {
+  const T* data = v.data();
+  const int64_t min = v.min_index();
+  detail::cache_line_chunks chunks(data, v.size(), pool.concurrency());
+  const std::size_t count = chunks.count();
+  if (count == 0) { return init; }
+  std::vector<std::optional<R>> partials(count);
+  pool.run(count, [&](std::size_t c) {
+    auto [first, last] = chunks.bounds(c);
+    R partial = map(min + static_cast<int64_t>(first), data[first]);
+    for (std::size_t i = first + 1; i < last; ++i) { partial = reduce(std::move(partial), map(min + static_cast<int64_t>(i), data[i])); }
+    partials[c] = std::move(partial);
+  });
+  for (std::optional<R>& partial : partials) { init = reduce(std::move(init), std::move(*partial)); }
+  return init;
+}
+
+}
@@ -0,0 +1,187 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <memory_resource>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+namespace stdx {
+
+/** Ring fixed vector class. A fixed vector backed by a circular buffer, for windows of indices that slide along continuously.
+
+ The element with index i is stored in slot i mod capacity(), where the capacity is a power of two, so moving the window never moves the elements in the overlap of the old and new ranges. Advancing the window by n indices costs O(n), making a window advancing one index at a time amortised O(1). Elements are accessed with the same absolute, possibly negative, indices as fixed_vector.
+
+ Elements are not contiguous in memory, so there is no data() member. Iterators visit the elements in index order.
+ */
+template <class T, class Allocator = std::allocator<T>>
+class ring_fixed_vector {
+  using base_type = std::vector<T, Allocator>;
+
+  template <bool Const>
+  class basic_iterator {
+    using container_type = std::conditional_t<Const, const ring_fixed_vector, ring_fixed_vector>;
+  public:
+    using iterator_category = std::bidirectional_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = std::conditional_t<Const, const T*, T*>;
+    using reference = std::conditional_t<Const, const T&, T&>;
+
+    basic_iterator() noexcept : parent(nullptr), pos(0) { }
+    basic_iterator(container_type* parent, int64_t pos) noexcept : parent(parent), pos(pos) { }
+    /** Conversion from iterator to const_iterator. */
+    template <bool C = Const, class = std::enable_if_t<C>>
+    basic_iterator(const basic_iterator<false>& other) noexcept : parent(other.parent), pos(other.pos) { }
+
+    reference operator*() const noexcept { return (*parent)[pos]; }
+    pointer operator->() const noexcept { return &(*parent)[pos]; }
+    basic_iterator& operator++() noexcept { ++pos; return *this; }
+    basic_iterator operator++(int) noexcept { basic_iterator tmp(*this); ++pos; return tmp; }
+    basic_iterator& operator--() noexcept { --pos; return *this; }
+    basic_iterator operator--(int) noexcept { basic_iterator tmp(*this); --pos; return tmp; }
+
+    /** Returns the index of the element the iterator refers to. */
+    int64_t index() const noexcept { return pos; }
+
+    friend bool operator==(const basic_iterator& lhs, const basic_iterator& rhs) noexcept { return lhs.pos == rhs.pos; }
+    friend bool operator!=(const basic_iterator& lhs, const basic_iterator& rhs) noexcept { return lhs.pos != rhs.pos; }
+    friend difference_type operator-(const basic_iterator& lhs, const basic_iterator& rhs) noexcept { return lhs.pos - rhs.pos; }
+
+  private:
+    friend class basic_iterator<true>;
+    container_type* parent;
+    int64_t pos;
+  };
+
+public:
+  /* Member types */
+  using value_type = T;
+  using allocator_type = Allocator;
+  using size_type = typename base_type::size_type;
+  using difference_type = typename base_type::difference_type;
+  using reference = typename base_type::reference;
+  using const_reference = typename base_type::const_reference;
+  using iterator = basic_iterator<false>;
+  using const_iterator = basic_iterator<true>;
+  using reverse_iterator = std::reverse_iterator<iterator>;
+  using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+  /* Constructors */
+  /** Default constructor.
+   *  Constructs a vector which cannot be filled, as it has zero range.
+   */
+  ring_fixed_vector() noexcept(noexcept(Allocator())) : elems(), minindex(0), maxindex(-1), mask(0) { }
+  explicit ring_fixed_vector(const Allocator& alloc) noexcept : elems(alloc), minindex(0), maxindex(-1), mask(0) { }
+
+  /** Construct the container with copies of \p value in the range \p min to \p max. Storage is allocated for at least \p capacity elements, so that the window can later grow to that size without reallocating. */
+  ring_fixed_vector(int64_t min, int64_t max, const T& value = T(), size_type capacity = 0, const Allocator& alloc = Allocator())
+  : elems(alloc), minindex(min), maxindex(max), mask(0) {
+    if (max < min) { throw std::range_error("Invalid construction range."); }
+    size_type slots = round_capacity(std::max(capacity, static_cast<size_type>(max - min + 1)));
+    elems.assign(slots, value);
+    mask = slots - 1;
+  }
+
+  /** Returns the allocator associated with the container. */
+  allocator_type get_allocator() const noexcept { return elems.get_allocator(); }
+
+  /** Return a reference to the element at specified location \p pos, with bounds checking. If \p pos is not within the range of the container, an exception of type std::out_of_range is thrown. */
+  reference at(int64_t pos) {
+    if (pos < minindex || pos > maxindex) { throw std::out_of_range("ring_fixed_vector::at"); }
+    return (*this)[pos];
+  }
+  const_reference at(int64_t pos) const {
+    if (pos < minindex || pos > maxindex) { throw std::out_of_range("ring_fixed_vector::at"); }
+    return (*this)[pos];
+  }
+
+  /** Returns a reference to the element at specified location pos. No bounds checking is performed. */
+  reference operator[](int64_t pos) noexcept { return elems[static_cast<uint64_t>(pos) & mask]; }
+  const_reference operator[](int64_t pos) const noexcept { return elems[static_cast<uint64_t>(pos) & mask]; }
+
+  /** Returns a reference to the element at the minimum index. */
+  reference front() noexcept { return (*this)[minindex]; }
+  const_reference front() const noexcept { return (*this)[minindex]; }
+  /** Returns a reference to the element at the maximum index. */
+  reference back() noexcept { return (*this)[maxindex]; }
+  const_reference back() const noexcept { return (*this)[maxindex]; }
+
+  /** Iterators visiting the elements in index order. */
+  iterator begin() noexcept { return iterator(this, minindex); }
+  const_iterator begin() const noexcept { return const_iterator(this, minindex); }
+  const_iterator cbegin() const noexcept { return const_iterator(this, minindex); }
+  iterator end() noexcept { return iterator(this, maxindex + 1); }
+  const_iterator end() const noexcept { return const_iterator(this, maxindex + 1); }
+  const_iterator cend() const noexcept { return const_iterator(this, maxindex + 1); }
+  reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+  const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+  reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+  const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+
+  /** Returns the number of elements. */
+  size_type size() const noexcept { return static_cast<size_type>(maxindex - minindex + 1); }
+  /** Returns the number of elements the window can hold without reallocating. Always a power of two. */
+  size_type capacity() const noexcept { return elems.size(); }
+  /** Returns the minimum index. */
+  int64_t min_index() const noexcept { return minindex; }
+  /** Returns the maximum index. */
+  int64_t max_index() const noexcept { return maxindex; }
+
+  /** Move the bounds of the container to [\p min, \p max], keeping elements at their indices.
+   *  Elements whose indices are in both the old and new ranges keep their values, and are not moved. All other elements in the new range are set to \p value. Takes time proportional to the number of new elements, unless the new range is larger than the capacity, in which case storage is reallocated.
+   */
+  void slide(int64_t min, int64_t max, const value_type& value = value_type()) {
+    if (max < min) { throw std::range_error("Invalid slide range."); }
+    const size_type new_size = static_cast<size_type>(max - min + 1);
+    if (new_size > capacity()) {
+      regrow(min, max, new_size, value);
+      return;
+    }
+    const int64_t lo = std::max(min, minindex), hi = std::min(max, maxindex);
+    if (lo > hi) {
+      for (int64_t i = min; i <= max; ++i) { (*this)[i] = value; }
+    } else {
+      for (int64_t i = min; i < lo; ++i) { (*this)[i] = value; }
+      for (int64_t i = hi + 1; i <= max; ++i) { (*this)[i] = value; }
+    }
+    minindex = min;
+    maxindex = max;
+  }
+  /** Advance the window by \p count indices, keeping its size. New elements are set to \p value. */
+  void advance(int64_t count = 1, const value_type& value = value_type()) { slide(minindex + count, maxindex + count, value); }
+
+private:
+  static size_type round_capacity(size_type n) noexcept {
+    size_type result = 1;
+    while (result < n) { result <<= 1; }
+    return result;
+  }
+
+  void regrow(int64_t min, int64_t max, size_type new_size, const value_type& value) {
+    const size_type slots = round_capacity(new_size);
+    base_type grown(slots, value, elems.get_allocator());
+    const uint64_t new_mask = slots - 1;
+    const int64_t lo = std::max(min, minindex), hi = std::min(max, maxindex);
+    for (int64_t i = lo; i <= hi; ++i) { grown[static_cast<uint64_t>(i) & new_mask] = std::move((*this)[i]); }
+    elems.swap(grown);
+    mask = new_mask;
+    minindex = min;
+    maxindex = max;
+  }
+
+  base_type elems;
+  int64_t minindex, maxindex;
+  uint64_t mask;
+};
+
+namespace pmr {
+template <class T>
+using ring_fixed_vector = stdx::ring_fixed_vector<T, std::pmr::polymorphic_allocator<T>>;
+}
+
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <stdexcept>
+
+namespace stdx {
+
+/** Static fixed vector class. Has the same interface as fixed_vector, but the index range [Min, Max] is fixed at compile time and elements are stored inline, so the container never allocates. Can have negative indices.
+
+ All operations are constexpr, so containers can be built and used in constant expressions.
+
+ \tparam T element type. Must be default constructible.
+ \tparam Min minimum index.
+ \tparam Max maximum index.
+ */
+template <class T, int64_t Min, int64_t Max>
+class static_fixed_vector {
+  static_assert(Max >= Min, "Invalid index range.");
+  using base_type = std::array<T, static_cast<std::size_t>(Max - Min + 1)>;
+public:
+  /* Member types */
+  using value_type = typename base_type::value_type;
+  using size_type = typename base_type::size_type;
+  using difference_type = typename base_type::difference_type;
+  using reference = typename base_type::reference;
+  using const_reference = typename base_type::const_reference;
+  using pointer = typename base_type::pointer;
+  using const_pointer = typename base_type::const_pointer;
+  using iterator = typename base_type::iterator;
+  using const_iterator = typename base_type::const_iterator;
+  using reverse_iterator = typename base_type::reverse_iterator;
+  using const_reverse_iterator = typename base_type::const_reverse_iterator;
+
+  /* Constructors */
+  /** Default constructor.
+   *  Constructs the container with value-initialised elements.
+   */
+  constexpr static_fixed_vector() : elems{} { }
+  /** Construct the container with copies of \p value. */
+  constexpr explicit static_fixed_vector(const T& value) : elems{} { fill(value); }
+  /** Initialiser list constructor. Elements from Min onwards are initialised from \p init, and any remaining elements are value-initialised. If \p init has more than size() elements, an exception of type std::range_error is thrown. */
+  constexpr static_fixed_vector(std::initializer_list<T> init) : elems{} {
+    if (init.size() > size()) { throw std::range_error("Invalid construction range."); }
+    size_type i = 0;
+    for (const T& value : init) { elems[i++] = value; }
+  }
+
+  /** Replace the contents with copies of \p value. */
+  constexpr void fill(const T& value) {
+    for (size_type i = 0; i < size(); ++i) { elems[i] = value; }
+  }
+
+  /** Return a reference to the element at specified location \p pos, with bounds checking. If \p pos is not within the range of the container, an exception of type std::out_of_range is thrown. */
+  constexpr reference at(int64_t pos) {
+    if (pos < Min || pos > Max) { throw std::out_of_range("static_fixed_vector::at"); }
+    return elems[static_cast<size_type>(pos - Min)];
+  }
+  constexpr const_reference at(int64_t pos) const {
+    if (pos < Min || pos > Max) { throw std::out_of_range("static_fixed_vector::at"); }
+    return elems[static_cast<size_type>(pos - Min)];
+  }
+
+  /** Returns a reference to the element at specified location pos. No bounds checking is performed. */
+  constexpr reference operator[](int64_t pos) { return elems[static_cast<size_type>(pos - Min)]; }
+  constexpr const_reference operator[](int64_t pos) const { return elems[static_cast<size_type>(pos - Min)]; }
+
+  /** Returns a reference to the first element in the container. */
+  constexpr reference front() { return elems.front(); }
+  constexpr const_reference front() const { return elems.front(); }
+
+  /** Returns a reference to the last element in the container. */
+  constexpr reference back() { return elems.back(); }
+  constexpr const_reference back() const { return elems.back(); }
+
+  /** Returns pointer to the underlying array serving as element storage. */
+  constexpr T* data() noexcept { return elems.data(); }
+  constexpr const T* data() const noexcept { return elems.data(); }
+
+  constexpr base_type& get_elems() { return elems; }
+  constexpr const base_type& get_elems() const { return elems; }
+
+  /** Returns an iterator to the first element of the vector. */
+  constexpr iterator begin() noexcept { return elems.begin(); }
+  constexpr const_iterator begin() const noexcept { return elems.begin(); }
+  constexpr const_iterator cbegin() const noexcept { return elems.cbegin(); }
+
+  /** Returns an iterator to the element following the last element of the vector. */
+  constexpr iterator end() noexcept { return elems.end(); }
+  constexpr const_iterator end() const noexcept { return elems.end(); }
+  constexpr const_iterator cend() const noexcept { return elems.cend(); }
+
+  /** Returns a reverse iterator to the first element of the reversed vector. */
+  constexpr reverse_iterator rbegin() noexcept { return elems.rbegin(); }
+  constexpr const_reverse_iterator rbegin() const noexcept { return elems.rbegin(); }
+  constexpr const_reverse_iterator crbegin() const noexcept { return elems.crbegin(); }
+
+  /** Returns a reverse iterator to the element following the last element of the reversed vector. */
+  constexpr reverse_iterator rend() noexcept { return elems.rend(); }
+  constexpr const_reverse_iterator rend() const noexcept { return elems.rend(); }
+  constexpr const_reverse_iterator crend() const noexcept { return elems.crend(); }
+
+  /** Returns the number of elements. */
+  static constexpr size_type size() noexcept { return static_cast<size_type>(Max - Min + 1); }
+  /** Returns the minimum index. */
+  static constexpr int64_t min_index() noexcept { return Min; }
+  /** Returns the maximum index. */
+  static constexpr int64_t max_index() noexcept { return Max; }
+
+protected:
+  base_type elems;
+};
+
+}
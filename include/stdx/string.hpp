@@ -1,9 +1,27 @@
 #pragma once
 
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
 #include <memory>
+#include <memory_resource>
+#include <stdexcept>
 #include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
 #include <vector>
 
+#include "ascii.hpp"
+#include "char_class.hpp"
+#include "convert.hpp"
+#include "instrumentation.hpp"
+#include "multi_pattern.hpp"
+#include "string_algorithms.hpp"
+#include "string_builder.hpp"
+#include "utf.hpp"
+
 namespace stdx {
 
 /** Extension of std::basic_string adding additional Python-like functionality
@@ -35,17 +53,23 @@ public:
   using const_iterator = typename parent_type::const_iterator;
   using reverse_iterator = typename parent_type::reverse_iterator;
   using const_reverse_iterator = typename parent_type::const_reverse_iterator;
+  using view_type = std::basic_string_view<CharT, Traits>;
+  using split_view_type = basic_split_view<CharT, Traits>;
+  using char_class_type = basic_char_class<CharT>;
+  using builder_type = basic_string_builder<CharT, Traits, Allocator>;
+  using multi_pattern_type = basic_multi_pattern<CharT, Traits>;
+  using match_type = pattern_match;
   
   /* Static constants */
   static const size_type npos = parent_type::npos;
-  // This constants may not work correctly for anything other than CharT = char
-  static const basic_string whitespace() { return {0x20, 0x0c, 0x0a, 0x0d, 0x09, 0x0b, 0x0}; }
-  static const basic_string lowercase() { return "abcdefghijklmnopqrstuvwxyz"; }
-  static const basic_string uppercase() { return "ABCDEFGHIJKLMNOPQRSTUVWXYZ"; }
-  static const basic_string digits() { return "0123456789"; }
-  static const basic_string hexdigits() { return "0123456789ABCDEFabcdef"; }
-  static const basic_string alpha() { return uppercase() + lowercase(); }
-  static const basic_string alphanumeric() { return digits() + alpha(); }
+  // Built once on first use. Prefer the matching char_classes members for stripping and splitting.
+  static const basic_string& whitespace() { static const basic_string value(std::begin(char_classes<CharT>::whitespace_chars), std::end(char_classes<CharT>::whitespace_chars)); return value; }
+  static const basic_string& lowercase() { static const basic_string value(std::begin(char_classes<CharT>::lowercase_chars), std::end(char_classes<CharT>::lowercase_chars)); return value; }
+  static const basic_string& uppercase() { static const basic_string value(std::begin(char_classes<CharT>::uppercase_chars), std::end(char_classes<CharT>::uppercase_chars)); return value; }
+  static const basic_string& digits() { static const basic_string value(std::begin(char_classes<CharT>::digit_chars), std::end(char_classes<CharT>::digit_chars)); return value; }
+  static const basic_string& hexdigits() { static const basic_string value(std::begin(char_classes<CharT>::hexdigit_chars), std::end(char_classes<CharT>::hexdigit_chars)); return value; }
+  static const basic_string& alpha() { static const basic_string value = uppercase() + lowercase(); return value; }
+  static const basic_string& alphanumeric() { static const basic_string value = digits() + alpha(); return value; }
   
   /* Constructors */
   /** Default constructor.
@@ -106,11 +130,11 @@ public:
   : parent_type(other, alloc) { }
   
   /** Move constructor.
-   * Constructs the string with the contents of \p other using move semantics. \p other is left in valid, but unspecified state.
+   * Constructs the string with the contents of \p other using move semantics, keeping its allocator. \p other is left in valid, but unspecified state. Never throws, so containers of strings move rather than copy them when they grow, and strings allocated from a memory resource stay there.
    */
-  basic_string(basic_string&& other)
+  basic_string(basic_string&& other) noexcept
   : parent_type(std::move(other)) { }
-  basic_string(parent_type&& other)
+  basic_string(parent_type&& other) noexcept
   : parent_type(std::move(other)) { }
   basic_string(basic_string&& other, const Allocator& alloc)
   : parent_type(std::move(other), alloc) { }
@@ -149,139 +173,433 @@ public:
   
   /* Override methods to enable return of stdx::basic_string, not std::basic_string.
    * Useful for chaining operations together. */
+  using parent_type::replace;
   /** Extract a substring.
-   *  Returns a substring [\p pos, \p pos +\p count). If the requested substring extends past the end of the string, or if \p count == \p npos, the returned substring is [\p pos, size()).
+   *  Returns a substring [\p pos, \p pos +\p count). If the requested substring extends past the end of the string, or if \p count == \p npos, the returned substring is [\p pos, size()). The substring uses a copy of the allocator of this.
    */
   basic_string substr(size_type pos = 0, size_type count = npos) const {
-    return parent_type::substr(pos, count);
+    basic_string result(*this, pos, count, this->get_allocator());
+    STDX_INSTRUMENT_CALL(substr, result.size(), sizeof(CharT));
+    STDX_INSTRUMENT_STRING(substr, result);
+    return result;
   }
   
-  /* New string operations */
+  /* New string operations
+   * Strings produced by these operations use a copy of the allocator of this. */
   /** Strip leading characters
-   *  Strips any leading characters given in \p chars from this, and returns a new string without the stripped characters. Defaults to stripping whitespace.
+   *  Strips any leading characters in the class \p chars from this, and returns a new string without the stripped characters. Defaults to stripping whitespace.
    */
-  basic_string lstrip(const basic_string& chars = whitespace()) const {
-    size_type pos = this->find_first_not_of(chars);
-    return (pos == npos) ? basic_string() : basic_string(this->begin() + pos, this->end());
-  }
+  basic_string lstrip(const char_class_type& chars = char_classes<CharT>::whitespace) const { return stripped(stdx::lstrip(view_type(*this), chars)); }
+  /** Strip leading characters
+   *  Strips any leading characters given in \p chars from this, and returns a new string without the stripped characters.
+   */
+  basic_string lstrip(const basic_string& chars) const { return stripped(stdx::lstrip(view_type(*this), view_type(chars))); }
   /** Strip trailing characters
-   *  Strips any trailing characters given in \p chars from this, and returns a new string without the stripped characters. Defaults to stripping whitespace.
+   *  Strips any trailing characters in the class \p chars from this, and returns a new string without the stripped characters. Defaults to stripping whitespace.
    */
-  basic_string rstrip(const basic_string& chars = whitespace()) const {
-    size_type pos = this->find_last_not_of(chars);
-    return (pos == npos) ? basic_string() : basic_string(this->begin(), this->begin() + pos + 1);
-  }
+  basic_string rstrip(const char_class_type& chars = char_classes<CharT>::whitespace) const { return stripped(stdx::rstrip(view_type(*this), chars)); }
+  /** Strip trailing characters
+   *  Strips any trailing characters given in \p chars from this, and returns a new string without the stripped characters.
+   */
+  basic_string rstrip(const basic_string& chars) const { return stripped(stdx::rstrip(view_type(*this), view_type(chars))); }
   /** Strip leading and trailing characters
-   *  Strips any leading and trailing characters given in \p chars from this, and returns a new string without the stripped characters. Defaults to stripping whitespace.
+   *  Strips any leading and trailing characters in the class \p chars from this, and returns a new string without the stripped characters. Defaults to stripping whitespace.
    */
-  basic_string strip(const basic_string& chars = whitespace()) const {
-    size_type left = this->find_first_not_of(chars);
-    size_type right = this->find_last_not_of(chars);
-    // If left == npos, then right will be too
-    return (left == npos) ? basic_string() : basic_string(this->begin() + left, this->begin() + right + 1);
-  }
+  basic_string strip(const char_class_type& chars = char_classes<CharT>::whitespace) const { return stripped(stdx::strip(view_type(*this), chars)); }
+  /** Strip leading and trailing characters
+   *  Strips any leading and trailing characters given in \p chars from this, and returns a new string without the stripped characters.
+   */
+  basic_string strip(const basic_string& chars) const { return stripped(stdx::strip(view_type(*this), view_type(chars))); }
   /** Strip leading characters
-   *  Strips any leading characters given in \p chars from this. Performs stripping inplace. Defaults to stripping whitespace.
+   *  Strips any leading characters in the class \p chars from this. Performs stripping inplace. Defaults to stripping whitespace.
    */
-  basic_string& lstrip_inplace(const basic_string& chars = whitespace()) {
-    size_type pos = this->find_first_not_of(chars);
-    (pos == npos) ? this->erase(this->begin(), this->end()) : this->erase(this->begin(), this->begin() + pos);
-    return *this;
-  }
+  basic_string& lstrip_inplace(const char_class_type& chars = char_classes<CharT>::whitespace) { return strip_to(stdx::lstrip(view_type(*this), chars)); }
+  /** Strip leading characters
+   *  Strips any leading characters given in \p chars from this. Performs stripping inplace.
+   */
+  basic_string& lstrip_inplace(const basic_string& chars) { return strip_to(stdx::lstrip(view_type(*this), view_type(chars))); }
   /** Strip trailing characters
-   *  Strips any trailing characters given in \p chars from this. Performs stripping inplace. Defaults to stripping whitespace.
+   *  Strips any trailing characters in the class \p chars from this. Performs stripping inplace. Defaults to stripping whitespace.
    */
-  basic_string& rstrip_inplace(const basic_string& chars = whitespace()) {
-    size_type pos = this->find_last_not_of(chars);
-    (pos == npos) ? this->erase(this->begin(), this->end()) : this->erase(this->begin() + pos + 1, this->end());
-    return *this;
-  }
+  basic_string& rstrip_inplace(const char_class_type& chars = char_classes<CharT>::whitespace) { return strip_to(stdx::rstrip(view_type(*this), chars)); }
+  /** Strip trailing characters
+   *  Strips any trailing characters given in \p chars from this. Performs stripping inplace.
+   */
+  basic_string& rstrip_inplace(const basic_string& chars) { return strip_to(stdx::rstrip(view_type(*this), view_type(chars))); }
   /** Strip leading and trailing characters
-   *  Strips any leading and trailing characters given in \p chars from this. Performs stripping inplace. Defaults to stripping whitespace.
-   */
-  basic_string& strip_inplace(const basic_string& chars = whitespace()) {
-    size_type right = this->find_last_not_of(chars);
-    // If right == npos, then left will be too
-    if (right == npos) {
-      this->erase(this->begin(), this->end());
-    } else {
-      this->resize(right + 1);
-      size_type left = this->find_first_not_of(chars);
-      this->erase(this->begin(), this->begin() + left);
-    }
-    return *this;
-  }
+   *  Strips any leading and trailing characters in the class \p chars from this. Performs stripping inplace. Defaults to stripping whitespace.
+   */
+  basic_string& strip_inplace(const char_class_type& chars = char_classes<CharT>::whitespace) { return strip_to(stdx::strip(view_type(*this), chars)); }
+  /** Strip leading and trailing characters
+   *  Strips any leading and trailing characters given in \p chars from this. Performs stripping inplace.
+   */
+  basic_string& strip_inplace(const basic_string& chars) { return strip_to(stdx::strip(view_type(*this), view_type(chars))); }
+  /** Strip leading Unicode whitespace
+   *  Strips any leading characters with the Unicode White_Space property from this UTF-8 string, and returns a new string without the stripped characters. Only the stripped characters are decoded. Use char_classes<CharT>::unicode_whitespace for UTF-16 and UTF-32 strings.
+   */
+  basic_string lstrip(utf8_whitespace_t) const { return stripped(stdx::lstrip(utf8_view(), utf8_whitespace)); }
+  /** Strip trailing Unicode whitespace
+   *  Strips any trailing characters with the Unicode White_Space property from this UTF-8 string, and returns a new string without the stripped characters.
+   */
+  basic_string rstrip(utf8_whitespace_t) const { return stripped(stdx::rstrip(utf8_view(), utf8_whitespace)); }
+  /** Strip leading and trailing Unicode whitespace
+   *  Strips any leading and trailing characters with the Unicode White_Space property from this UTF-8 string, and returns a new string without the stripped characters.
+   */
+  basic_string strip(utf8_whitespace_t) const { return stripped(stdx::strip(utf8_view(), utf8_whitespace)); }
+  /** Strip leading Unicode whitespace
+   *  As lstrip(utf8_whitespace), but performs stripping inplace.
+   */
+  basic_string& lstrip_inplace(utf8_whitespace_t) { return strip_to(stdx::lstrip(utf8_view(), utf8_whitespace)); }
+  /** Strip trailing Unicode whitespace
+   *  As rstrip(utf8_whitespace), but performs stripping inplace.
+   */
+  basic_string& rstrip_inplace(utf8_whitespace_t) { return strip_to(stdx::rstrip(utf8_view(), utf8_whitespace)); }
+  /** Strip leading and trailing Unicode whitespace
+   *  As strip(utf8_whitespace), but performs stripping inplace.
+   */
+  basic_string& strip_inplace(utf8_whitespace_t) { return strip_to(stdx::strip(utf8_view(), utf8_whitespace)); }
   /** Concatenate a range of strings together.
-   *  Strings are concatenated together using the value of this as the divider between strings.
+   *  Strings are concatenated together using the value of this as the divider between strings. Elements may be anything convertible to a string view, characters, or numbers (formatted by std::to_chars). Single-pass input ranges are accepted. For forward ranges of strings and characters, the total length is computed first so that the result is allocated exactly once.
    */
   template <typename InputIt>
   basic_string join(InputIt first, InputIt last) const {
-    basic_string result;
-    size_type num_joiners = std::distance(first, last) - 1;
-    size_type total_length = 0;
-    for (InputIt begin = first; begin != last; ++begin) { total_length += first->size(); }
-    result.reserve(num_joiners * this->size() + total_length + 1);
-    while (first != last) {
-      result.append(*first);
-      if (num_joiners--) { result.append(*this); }
-      ++first;
-    }
-    result.shrink_to_fit();
+    builder_type builder(this->get_allocator());
+    basic_string result = stdx::join_into(builder, view_type(*this), first, last).take();
+    STDX_INSTRUMENT_STRING(join, result);
     return result;
   }
+  /** Concatenate the elements of \p range together, using the value of this as the divider between them. */
+  template <typename Range>
+  basic_string join(const Range& range) const {
+    using std::begin;
+    using std::end;
+    return join(begin(range), end(range));
+  }
   /** Split a string into components given a separator character.
-   *  Splits string at the locations of the given separator character. If \p separator is negative, will split at white space. If \p treat_consecutive_as_one is false, will add a blank string for each pair of consecutive separators. This is ignored when splitting on whitespace.
+   *  Splits string at the locations of the given separator character. If \p separator is negative (or -1 converted to an unsigned character type), will split at white space. If \p treat_consecutive_as_one is false, will add a blank string for each pair of consecutive separators. This is ignored when splitting on whitespace.
    */
   template <typename OutputIt>
   void split(OutputIt out, CharT separator = -1, bool treat_consecutive_as_one = true) const {
-    size_type idx = 0, previous = 0;
-    if (separator < 0 || treat_consecutive_as_one) {
-      basic_string sep = whitespace();
-      if (separator >= 0) { sep = basic_string(1, separator); }
-      while (idx < this->size()) {
-        size_type start = this->find_first_not_of(sep, idx);
-        if (start == npos) { break; } // Only separators in the string
-        size_type end = this->find_first_of(sep, start);
-        if (end == npos) { out = substr(start); }
-        else { out = substr(start, end - start); }
-        idx = end;
-        ++out;
-      }
-    } else {
-      for (CharT c : *this) {
-        if (c == separator) {
-          out = substr(previous, idx - previous);
-          previous = idx + 1;
-        }
-        ++idx;
-        ++out;
-      }
-      if (previous <= idx) { out = substr(previous, idx - previous); ++out; }
+    STDX_INSTRUMENT_CALL(split, this->size(), sizeof(CharT));
+    for (auto token : split_lazy(separator, treat_consecutive_as_one)) {
+      basic_string component(token.data(), token.size(), this->get_allocator());
+      STDX_INSTRUMENT_STRING(split, component);
+      *out = std::move(component);
+      ++out;
     }
   }
-  
-  /** Convert to numeric type.
-   *  Performs conversion of the string to the target type. Only works for numerical types.
+  /** Split a string into components given a class of separator characters.
+   *  Splits string at the locations of any of the characters in \p separators. If \p treat_consecutive_as_one is false, will add a blank string for each pair of consecutive separators.
    */
-  template <typename T>
-  T convert() const {
-    using namespace std;
-    if constexpr(is_same_v<float, T>) { return strtof(this->c_str(), nullptr); }
-    else if constexpr(is_same_v<double, T>) { return strtod(this->c_str(), nullptr); }
-    else if constexpr(is_same_v<long double, T>) { return strtold(this->c_str(), nullptr); }
-    else if constexpr(is_same_v<int8_t, T> || is_same_v<int16_t, T> || is_same_v<int32_t, T>) {
-      return (T)strtol(this->c_str(), nullptr, 10);
+  template <typename OutputIt>
+  void split(OutputIt out, const char_class_type& separators, bool treat_consecutive_as_one = true) const {
+    STDX_INSTRUMENT_CALL(split, this->size(), sizeof(CharT));
+    for (auto token : split_lazy(separators, treat_consecutive_as_one)) {
+      basic_string component(token.data(), token.size(), this->get_allocator());
+      STDX_INSTRUMENT_STRING(split, component);
+      *out = std::move(component);
+      ++out;
     }
-    else if constexpr(is_same_v<uint8_t, T> || is_same_v<uint16_t, T> || is_same_v<uint32_t, T>) {
-      return (T)strtoul(this->c_str(), nullptr, 10);
+  }
+  /** Split a UTF-8 string at Unicode whitespace.
+   *  Splits this at runs of characters with the Unicode White_Space property, never producing empty components. Whitespace is recognised as the string is scanned, without decoding it first. Use char_classes<CharT>::unicode_whitespace for UTF-16 and UTF-32 strings.
+   */
+  template <typename OutputIt>
+  void split(OutputIt out, utf8_whitespace_t) const {
+    STDX_INSTRUMENT_CALL(split, this->size(), sizeof(CharT));
+    for (auto token : split_lazy(utf8_whitespace)) {
+      basic_string component = from_utf8_view(token);
+      STDX_INSTRUMENT_STRING(split, component);
+      *out = std::move(component);
+      ++out;
+    }
+  }
+  /** Split a string into components, interning them into a pool.
+   *  As split, but adds each component to \p pool, and writes its id to \p out. Components already in the pool cost a hash lookup, rather than an allocation. \p pool may be a stdx::basic_string_pool or stdx::basic_concurrent_string_pool.
+   */
+  template <typename OutputIt, typename Pool>
+  auto split(OutputIt out, Pool& pool, CharT separator = -1, bool treat_consecutive_as_one = true) const
+  -> decltype(pool.intern(view_type()), void()) {
+    STDX_INSTRUMENT_CALL(split, this->size(), sizeof(CharT));
+    for (auto token : split_lazy(separator, treat_consecutive_as_one)) {
+      *out = pool.intern(token);
+      ++out;
     }
-    else if constexpr(is_same_v<int64_t, T>) { return (T)strtoll(this->c_str(), nullptr, 10); }
-    else if constexpr(is_same_v<uint64_t, T>) { return (T)strtoull(this->c_str(), nullptr, 10); }
-    else {
-      static_assert(is_same_v<float, T>, "Unsupported type conversion");
+  }
+  /** Split a string into components given a class of separator characters, interning them into a pool. */
+  template <typename OutputIt, typename Pool>
+  auto split(OutputIt out, Pool& pool, const char_class_type& separators, bool treat_consecutive_as_one = true) const
+  -> decltype(pool.intern(view_type()), void()) {
+    STDX_INSTRUMENT_CALL(split, this->size(), sizeof(CharT));
+    for (auto token : split_lazy(separators, treat_consecutive_as_one)) {
+      *out = pool.intern(token);
+      ++out;
     }
   }
+  /** Lazily split a string into components given a separator character.
+   *  As split, but returns a range of string views into this string that are computed on demand. At most \p maxsplit splits are performed. The string must outlive the returned range.
+   */
+  split_view_type split_lazy(CharT separator = -1, bool treat_consecutive_as_one = true, size_type maxsplit = npos) const noexcept {
+    return split_view_type(*this, separator, treat_consecutive_as_one, maxsplit);
+  }
+  /** Lazily split a UTF-8 string at Unicode whitespace.
+   *  As split(out, utf8_whitespace), but returns a range of std::string_view into this string that are computed on demand. The string must outlive the returned range.
+   */
+  utf8_split_view split_lazy(utf8_whitespace_t) const noexcept { return utf8_split_view(utf8_view()); }
+  /** Lazily split a string into components, starting from the end of the string.
+   *  As split_lazy, but splits are performed from the right, so that when \p maxsplit is given the remainder is the leftmost token. Tokens are yielded from right to left.
+   */
+  split_view_type rsplit_lazy(CharT separator = -1, bool treat_consecutive_as_one = true, size_type maxsplit = npos) const noexcept {
+    return split_view_type(*this, separator, treat_consecutive_as_one, maxsplit, true);
+  }
+  /** Lazily split a string into components given a class of separator characters. The class is referred to by the returned range, so must outlive it. */
+  split_view_type split_lazy(const char_class_type& separators, bool treat_consecutive_as_one = true, size_type maxsplit = npos) const noexcept {
+    return split_view_type(*this, separators, treat_consecutive_as_one, maxsplit);
+  }
+  void split_lazy(const char_class_type&&, bool = true, size_type = npos) const = delete;
+  /** Lazily split a string into components given a class of separator characters, starting from the end of the string. The class must outlive the returned range. */
+  split_view_type rsplit_lazy(const char_class_type& separators, bool treat_consecutive_as_one = true, size_type maxsplit = npos) const noexcept {
+    return split_view_type(*this, separators, treat_consecutive_as_one, maxsplit, true);
+  }
+  void rsplit_lazy(const char_class_type&&, bool = true, size_type = npos) const = delete;
   
+  /** Count occurrences of a substring.
+   *  Returns the number of non-overlapping occurrences of \p sub in [\p start, \p end). If \p sub is empty, returns the number of positions between characters in the range, as Python's str.count does.
+   */
+  size_type count(view_type sub, size_type start = 0, size_type end = npos) const noexcept {
+    if (start > this->size()) { return 0; }
+    const view_type text = view_type(*this).substr(start, end < start ? 0 : end - start);
+    if (sub.empty()) { return text.size() + 1; }
+    size_type result = 0;
+    for (size_type pos = text.find(sub); pos != npos; pos = text.find(sub, pos + sub.size())) { ++result; }
+    return result;
+  }
+  /** Count occurrences of any of a set of patterns.
+   *  Returns the number of non-overlapping matches of \p patterns, found in a single pass over the string.
+   */
+  size_type count(const multi_pattern_type& patterns) const noexcept { return patterns.count(view_type(*this)); }
+  /** Find the first match of any of a set of patterns.
+   *  Returns the leftmost match of \p patterns starting at or after \p pos, choosing the longest pattern if several match there. If there is no match, the returned match has pos == npos.
+   */
+  match_type find_any(const multi_pattern_type& patterns, size_type pos = 0) const noexcept { return patterns.find(view_type(*this), pos); }
+
+  /** Replace occurrences of a substring.
+   *  Returns a copy of this with the first \p maxcount non-overlapping occurrences of \p old_value replaced by \p new_value, defaulting to all occurrences. If \p old_value is empty, \p new_value is inserted before every character and at the end, as Python's str.replace does. The occurrences are counted first, so the result is allocated exactly once.
+   */
+  basic_string replace(view_type old_value, view_type new_value, size_type maxcount = npos) const {
+    const view_type text(*this);
+    if (old_value.empty()) {
+      const size_type matches = std::min(maxcount, text.size() + 1);
+      builder_type builder(text.size() + matches * new_value.size(), this->get_allocator());
+      for (size_type i = 0; i < matches; ++i) {
+        builder.append(new_value);
+        if (i < text.size()) { builder.push_back(text[i]); }
+      }
+      builder.append(text.substr(std::min(matches, text.size())));
+      return builder.take();
+    }
+    size_type matches = 0;
+    for (size_type pos = text.find(old_value); pos != npos && matches < maxcount; pos = text.find(old_value, pos + old_value.size())) { ++matches; }
+    if (matches == 0) { return basic_string(*this, this->get_allocator()); }
+    builder_type builder(text.size() - matches * old_value.size() + matches * new_value.size(), this->get_allocator());
+    size_type last = 0;
+    for (size_type i = 0; i < matches; ++i) {
+      const size_type pos = text.find(old_value, last);
+      builder.append(text.substr(last, pos - last)).append(new_value);
+      last = pos + old_value.size();
+    }
+    builder.append(text.substr(last));
+    return builder.take();
+  }
+  /** Replace matches of any of a set of patterns.
+   *  Returns a copy of this with the first \p maxcount non-overlapping matches of \p patterns replaced, defaulting to all matches. A match of the pattern numbered i is replaced by the i-th element of \p replacements, which must have one element for each pattern, or an exception of type std::invalid_argument is thrown. The matches are found in a single pass over the string to compute the length of the result, which is allocated exactly once, and a second pass to fill it.
+   */
+  template <typename Range>
+  basic_string replace(const multi_pattern_type& patterns, const Range& replacements, size_type maxcount = npos) const {
+    using std::begin;
+    const auto replacement = begin(replacements);
+    if (static_cast<size_type>(std::size(replacements)) != patterns.size()) { throw std::invalid_argument("Replacement count does not match pattern count."); }
+    const view_type text(*this);
+    size_type matches = 0, length = text.size();
+    for (match_type m = patterns.find(text); m && matches < maxcount; m = patterns.find(text, m.pos + m.length), ++matches) {
+      length = length - m.length + view_type(replacement[m.pattern]).size();
+    }
+    if (matches == 0) { return basic_string(*this, this->get_allocator()); }
+    builder_type builder(length, this->get_allocator());
+    size_type last = 0;
+    for (match_type m = patterns.find(text); matches > 0; m = patterns.find(text, last), --matches) {
+      builder.append(text.substr(last, m.pos - last)).append(view_type(replacement[m.pattern]));
+      last = m.pos + m.length;
+    }
+    builder.append(text.substr(last));
+    return builder.take();
+  }
+  /** Replace occurrences of a substring
+   *  As replace, but performs replacement inplace. When \p new_value is no longer than \p old_value, no memory is allocated.
+   */
+  basic_string& replace_inplace(view_type old_value, view_type new_value, size_type maxcount = npos) {
+    if (old_value.empty() || new_value.size() > old_value.size()) {
+      *this = replace(old_value, new_value, maxcount);
+      return *this;
+    }
+    // Replacements never lengthen the string, so the write position never passes the read position
+    CharT* data = &(*this)[0];
+    const view_type text(data, this->size());
+    size_type read = 0, write = 0, matches = 0;
+    for (size_type pos = text.find(old_value); pos != npos && matches < maxcount; pos = text.find(old_value, read), ++matches) {
+      Traits::move(data + write, data + read, pos - read);
+      write += pos - read;
+      Traits::copy(data + write, new_value.data(), new_value.size());
+      write += new_value.size();
+      read = pos + old_value.size();
+    }
+    Traits::move(data + write, data + read, text.size() - read);
+    this->resize(write + text.size() - read);
+    return *this;
+  }
+
+  /** Returns true if the string starts with \p prefix. */
+  bool startswith(view_type prefix) const noexcept {
+    return this->size() >= prefix.size() && Traits::compare(this->data(), prefix.data(), prefix.size()) == 0;
+  }
+  /** Returns true if the string starts with any of \p prefixes. */
+  bool startswith(std::initializer_list<view_type> prefixes) const noexcept {
+    for (view_type prefix : prefixes) { if (startswith(prefix)) { return true; } }
+    return false;
+  }
+  /** Returns true if the string ends with \p suffix. */
+  bool endswith(view_type suffix) const noexcept {
+    return this->size() >= suffix.size() && Traits::compare(this->data() + this->size() - suffix.size(), suffix.data(), suffix.size()) == 0;
+  }
+  /** Returns true if the string ends with any of \p suffixes. */
+  bool endswith(std::initializer_list<view_type> suffixes) const noexcept {
+    for (view_type suffix : suffixes) { if (endswith(suffix)) { return true; } }
+    return false;
+  }
+
+  /** Split the string at the first occurrence of a separator.
+   *  Returns the part before \p separator, the separator itself, and the part after it. If the separator is not found, returns this and two empty strings. If \p separator is empty, an exception of type std::invalid_argument is thrown.
+   */
+  std::tuple<basic_string, basic_string, basic_string> partition(view_type separator) const {
+    if (separator.empty()) { throw std::invalid_argument("Empty separator."); }
+    const size_type pos = view_type(*this).find(separator);
+    if (pos == npos) { return {basic_string(*this, this->get_allocator()), basic_string(this->get_allocator()), basic_string(this->get_allocator())}; }
+    return {substr(0, pos), substr(pos, separator.size()), substr(pos + separator.size())};
+  }
+  /** Split the string at the last occurrence of a separator.
+   *  Returns the part before \p separator, the separator itself, and the part after it. If the separator is not found, returns two empty strings and this. If \p separator is empty, an exception of type std::invalid_argument is thrown.
+   */
+  std::tuple<basic_string, basic_string, basic_string> rpartition(view_type separator) const {
+    if (separator.empty()) { throw std::invalid_argument("Empty separator."); }
+    const size_type pos = view_type(*this).rfind(separator);
+    if (pos == npos) { return {basic_string(this->get_allocator()), basic_string(this->get_allocator()), basic_string(*this, this->get_allocator())}; }
+    return {substr(0, pos), substr(pos, separator.size()), substr(pos + separator.size())};
+  }
+
+  /** Convert to lower case
+   *  Returns a copy of this with ASCII letters converted to lower case. Other characters, including non-ASCII letters, are unchanged, so the result does not depend on the locale. Single byte strings are converted with SIMD kernels.
+   */
+  basic_string lower() const { return converted<detail::ascii_case::lower>(); }
+  /** Convert to upper case
+   *  Returns a copy of this with ASCII letters converted to upper case. See lower.
+   */
+  basic_string upper() const { return converted<detail::ascii_case::upper>(); }
+  /** Swap case
+   *  Returns a copy of this with ASCII lower case letters converted to upper case, and vice versa. See lower.
+   */
+  basic_string swapcase() const { return converted<detail::ascii_case::swap>(); }
+  /** Fold case for caseless comparison
+   *  Only ASCII letters are folded, so this is the same as lower. Strings folded this way compare equal exactly when iequals is true.
+   */
+  basic_string casefold() const { return converted<detail::ascii_case::lower>(); }
+  /** Convert to lower case
+   *  As lower, but performs conversion inplace.
+   */
+  basic_string& lower_inplace() noexcept { return convert_inplace<detail::ascii_case::lower>(); }
+  /** Convert to upper case
+   *  As upper, but performs conversion inplace.
+   */
+  basic_string& upper_inplace() noexcept { return convert_inplace<detail::ascii_case::upper>(); }
+  /** Swap case
+   *  As swapcase, but performs conversion inplace.
+   */
+  basic_string& swapcase_inplace() noexcept { return convert_inplace<detail::ascii_case::swap>(); }
+  /** Fold case for caseless comparison
+   *  As casefold, but performs conversion inplace.
+   */
+  basic_string& casefold_inplace() noexcept { return convert_inplace<detail::ascii_case::lower>(); }
+  /** Returns true if this and \p other are equal, ignoring the case of ASCII letters. See stdx::iequals. */
+  bool iequals(view_type other) const noexcept { return stdx::iequals(view_type(*this), other); }
+
+  /** Convert to numeric type.
+   *  Performs conversion of the string to the target type. Only works for numerical types. As with std::strtol, leading whitespace and a '+' before the number are skipped, and conversion stops at the first character that is not part of the number. Returns zero if no conversion could be performed. Conversion uses std::from_chars, so does not depend on the current locale.
+   *  Floating point numbers may be hexadecimal, as in "0x1.8p3", as with std::strtod. Values out of the range of the target type saturate: integers to its minimum or maximum, floating point to infinity or zero. Unlike std::strtoul, a negative number converted to an unsigned type gives zero.
+   */
+  template <typename T>
+  T convert() const {
+    static_assert(std::is_same_v<CharT, char>, "Numeric conversion is only supported for CharT = char");
+    return detail::convert_leading<T>(view_type(*this));
+  }
+  /** Convert to numeric type, reporting errors.
+   *  The whole string must be a number in the format accepted by std::from_chars. See stdx::convert.
+   */
+  template <typename T>
+  convert_result<T> try_convert() const noexcept {
+    static_assert(std::is_same_v<CharT, char>, "Numeric conversion is only supported for CharT = char");
+    return stdx::convert<T>(view_type(*this));
+  }
+
+  /** Type of the result of transcoding to character type \p ToCharT, using the allocator of this rebound to it. */
+  template <typename ToCharT>
+  using transcoded_type = basic_string<ToCharT, std::char_traits<ToCharT>, typename std::allocator_traits<Allocator>::template rebind_alloc<ToCharT>>;
+  /** Convert to UTF-8
+   *  Transcodes this to UTF-8, in a single pass. The encoding of this is given by CharT: UTF-8 for char, UTF-16 for char16_t, UTF-32 for char32_t, and UTF-16 or UTF-32 for wchar_t, depending on its size. If this is not valid, an exception of type std::range_error is thrown. See stdx::utf_transcode.
+   */
+  transcoded_type<char> to_utf8() const { return transcoded<char>(); }
+  /** Convert to UTF-16
+   *  Transcodes this to UTF-16. See to_utf8.
+   */
+  transcoded_type<char16_t> to_utf16() const { return transcoded<char16_t>(); }
+  /** Convert to UTF-32
+   *  Transcodes this to UTF-32. See to_utf8.
+   */
+  transcoded_type<char32_t> to_utf32() const { return transcoded<char32_t>(); }
+
+private:
+  template <typename ToCharT>
+  transcoded_type<ToCharT> transcoded() const {
+    transcoded_type<ToCharT> result(typename transcoded_type<ToCharT>::allocator_type(this->get_allocator()));
+    utf_transcode(view_type(*this), result);
+    return result;
+  }
+  std::string_view utf8_view() const noexcept {
+    static_assert(std::is_same_v<CharT, char>, "Unicode whitespace in UTF-8 is only supported for CharT = char");
+    return std::string_view(this->data(), this->size());
+  }
+  basic_string from_utf8_view(std::string_view v) const { return basic_string(v.data(), v.size(), this->get_allocator()); }
+  /* Results of the strip operations: the characters \p kept of this, as a new string or by erasing the others. */
+  basic_string stripped(view_type kept) const {
+    basic_string result(kept.data(), kept.size(), this->get_allocator());
+    STDX_INSTRUMENT_STRING(strip, result);
+    return result;
+  }
+  basic_string& strip_to(view_type kept) {
+    const size_type left = static_cast<size_type>(kept.data() - this->data());
+    this->erase(left + kept.size());
+    this->erase(0, left);
+    return *this;
+  }
+  template <detail::ascii_case Case>
+  basic_string converted() const {
+    basic_string result(this->size(), CharT(), this->get_allocator());
+    detail::ascii_convert<Case>(&result[0], this->data(), this->size());
+    return result;
+  }
+  template <detail::ascii_case Case>
+  basic_string& convert_inplace() noexcept {
+    detail::ascii_convert<Case>(&(*this)[0], this->data(), this->size());
+    return *this;
+  }
 };
 
 /** Typedefs for common character types **/
@@ -290,4 +608,14 @@ using wstring = basic_string<wchar_t>;
 using u16string = basic_string<char16_t>;
 using u32string = basic_string<char32_t>;
 
+namespace pmr {
+template <class CharT, class Traits = std::char_traits<CharT>>
+using basic_string = stdx::basic_string<CharT, Traits, std::pmr::polymorphic_allocator<CharT>>;
+
+using string = basic_string<char>;
+using wstring = basic_string<wchar_t>;
+using u16string = basic_string<char16_t>;
+using u32string = basic_string<char32_t>;
+}
+
 }
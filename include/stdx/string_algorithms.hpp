@@ -0,0 +1,830 @@
+#pragma once
+
+#include <charconv>
+#include <cstddef>
+#include <functional>
+#include <iosfwd>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#include "char_class.hpp"
+#include "convert.hpp"
+#include "instrumentation.hpp"
+#include "string_builder.hpp"
+#include "utf.hpp"
+
+namespace stdx {
+
+/** Lazy range of tokens produced by splitting a string.
+ 
+ Tokens are std::basic_string_view instances referring into the original buffer, and are only computed as the range is iterated, so splitting never allocates. The referenced buffer must outlive the view and any tokens taken from it. Iterators refer to the view they were obtained from.
+ 
+ Splitting follows the same rules as basic_string::split. Whitespace mode (a negative \p separator, or for unsigned character types the largest value, which -1 converts to) treats runs of whitespace as a single separator and never produces empty tokens. With a separator character or character class, consecutive separators are merged when \p treat_consecutive_as_one is true, otherwise an empty token is produced between each pair. At most \p maxsplit splits are performed, the remainder of the string becoming the last token.
+ 
+ A reverse split view performs the splits starting from the end of the string (as Python's rsplit does), and yields its tokens from right to left.
+ 
+ A character class of separators is referred to rather than copied, so it must also outlive the view; temporaries are rejected. Whitespace mode refers to char_classes<CharT>::whitespace.
+ 
+ \tparam CharT character type.
+ \tparam Traits traits class specifying the operations on the character type
+ */
+template <class CharT, class Traits = std::char_traits<CharT>>
+class basic_split_view {
+public:
+  /* Member types */
+  using view_type = std::basic_string_view<CharT, Traits>;
+  using size_type = typename view_type::size_type;
+  using char_class_type = basic_char_class<CharT>;
+  
+  static constexpr size_type npos = view_type::npos;
+  
+  /** Forward iterator over the tokens of a basic_split_view. */
+  class iterator {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = view_type;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const view_type*;
+    using reference = const view_type&;
+    
+    /** Constructs an end iterator. */
+    iterator() noexcept : parent(nullptr), rest(), token(), splits(0), pending(false), at_end(true) { }
+    
+    reference operator*() const noexcept { return token; }
+    pointer operator->() const noexcept { return &token; }
+    
+    iterator& operator++() { advance(); return *this; }
+    iterator operator++(int) { iterator tmp(*this); advance(); return tmp; }
+    
+    friend bool operator==(const iterator& lhs, const iterator& rhs) noexcept {
+      if (lhs.at_end || rhs.at_end) { return lhs.at_end == rhs.at_end; }
+      return lhs.token.data() == rhs.token.data() && lhs.token.size() == rhs.token.size();
+    }
+    friend bool operator!=(const iterator& lhs, const iterator& rhs) noexcept { return !(lhs == rhs); }
+    
+  private:
+    friend class basic_split_view;
+    
+    explicit iterator(const basic_split_view* view)
+    : parent(view), rest(view->str), token(), splits(0), pending(true), at_end(false) { advance(); }
+    
+    void advance() {
+      if (!pending) { at_end = true; return; }
+      const bool merge = parent->merge;
+      const bool reverse = parent->reverse;
+      if (merge) {
+        if (reverse) {
+          size_type last = parent->find_last_not_sep(rest);
+          rest = (last == npos) ? view_type() : rest.substr(0, last + 1);
+        } else {
+          size_type first = parent->find_first_not_sep(rest);
+          rest = (first == npos) ? view_type() : rest.substr(first);
+        }
+        if (rest.empty()) { pending = false; at_end = true; return; }
+      }
+      if (splits == parent->maxsplit) { token = rest; pending = false; return; }
+      size_type pos = reverse ? parent->find_last_sep(rest) : parent->find_first_sep(rest);
+      if (pos == npos) { token = rest; pending = false; return; }
+      ++splits;
+      if (reverse) {
+        token = rest.substr(pos + 1);
+        rest = rest.substr(0, pos);
+      } else {
+        token = rest.substr(0, pos);
+        rest = rest.substr(pos + 1);
+      }
+    }
+    
+    const basic_split_view* parent;
+    view_type rest;
+    view_type token;
+    size_type splits;
+    bool pending;
+    bool at_end;
+  };
+  using const_iterator = iterator;
+  
+  /* Constructors */
+  /** Construct a view splitting \p str at \p separator. If \p separator is negative, or for unsigned character types is static_cast<CharT>(-1), splits at whitespace. */
+  explicit basic_split_view(view_type str, CharT separator = static_cast<CharT>(-1), bool treat_consecutive_as_one = true,
+                            size_type maxsplit = npos, bool reverse = false) noexcept
+  : str(str), classes(is_whitespace_separator(separator) ? &char_classes<CharT>::whitespace : nullptr), separator(separator),
+    merge(classes != nullptr || treat_consecutive_as_one), reverse(reverse), maxsplit(maxsplit) { }
+  /** Construct a view splitting \p str at any of the characters in \p separators, which must outlive the view. */
+  basic_split_view(view_type str, const char_class_type& separators, bool treat_consecutive_as_one = true,
+                   size_type maxsplit = npos, bool reverse = false) noexcept
+  : str(str), classes(&separators), separator(), merge(treat_consecutive_as_one), reverse(reverse), maxsplit(maxsplit) { }
+  basic_split_view(view_type, const char_class_type&&, bool = true, size_type = npos, bool = false) = delete;
+  
+  /** Returns an iterator to the first token. */
+  iterator begin() const { return iterator(this); }
+  /** Returns the end iterator. */
+  iterator end() const noexcept { return iterator(); }
+  
+  /** Returns true if the range contains no tokens. */
+  bool empty() const { return begin() == end(); }
+  
+  /** Returns the string being split. */
+  view_type base() const noexcept { return str; }
+  
+private:
+  /** Returns true if \p separator selects whitespace mode. Unsigned character types such as char16_t have no negative values, so -1 arrives as the largest value, which is not a valid code unit in UTF-16 or UTF-32. */
+  static constexpr bool is_whitespace_separator(CharT separator) noexcept {
+    if constexpr (std::is_signed_v<CharT>) { return separator < 0; } else { return separator == static_cast<CharT>(-1); }
+  }
+
+  size_type find_first_sep(view_type v) const noexcept {
+    return classes ? classes->find_first_of(v) : v.find(separator);
+  }
+  size_type find_last_sep(view_type v) const noexcept {
+    return classes ? classes->find_last_of(v) : v.rfind(separator);
+  }
+  size_type find_first_not_sep(view_type v) const noexcept {
+    return classes ? classes->find_first_not_of(v) : v.find_first_not_of(separator);
+  }
+  size_type find_last_not_sep(view_type v) const noexcept {
+    return classes ? classes->find_last_not_of(v) : v.find_last_not_of(separator);
+  }
+  
+  view_type str;
+  const char_class_type* classes; // Separator class, or null to split at separator
+  CharT separator;
+  bool merge;
+  bool reverse;
+  size_type maxsplit;
+};
+
+namespace detail {
+
+template <class T>
+struct nondeduced { using type = T; };
+/* Parameters of this type do not take part in template argument deduction, so accept anything convertible to T. */
+template <class T>
+using nondeduced_t = typename nondeduced<T>::type;
+
+/* Count a strip of \p str which kept \p kept, and return \p kept. */
+template <class View>
+View count_strip([[maybe_unused]] View str, View kept) noexcept {
+  STDX_INSTRUMENT_CALL(strip, str.size() - kept.size(), sizeof(typename View::value_type));
+  return kept;
+}
+
+/* Append one element of a join to \p out: a character, anything convertible to a string view, or a number formatted by std::to_chars. */
+template <class CharT, class Traits, class Builder, class T>
+void append_joined(Builder& out, const T& value) {
+  if constexpr (std::is_same_v<T, CharT>) { out.push_back(value); }
+  else if constexpr (is_string_like_v<T, CharT, Traits>) { out.append(std::basic_string_view<CharT, Traits>(value)); }
+  else if constexpr (is_number_like_v<T, CharT>) {
+    char digits[128];
+    auto result = std::to_chars(digits, digits + sizeof(digits), value);
+    const std::size_t count = static_cast<std::size_t>(result.ptr - digits);
+    if constexpr (std::is_same_v<CharT, char>) {
+      out.append(std::basic_string_view<CharT, Traits>(digits, count));
+    } else {
+      for (std::size_t i = 0; i < count; ++i) { out.push_back(static_cast<CharT>(digits[i])); }
+    }
+  } else {
+    static_assert(std::is_same_v<T, CharT>, "Unsupported type for join");
+  }
+}
+
+/* For the characters from \p first to \p last, a floating point number outside the range of its type, returns true if it is too large rather than too small. The limits of the range are far from 1, so the sign of the decimal (or for hex, binary) exponent of the leading significant digit decides. */
+inline bool float_overflows(const char* first, const char* last, bool hex) noexcept {
+  const char marker = hex ? 'p' : 'e';
+  long long scale = 0;
+  bool before_point = true, significant = false;
+  for (; first != last && (*first | 0x20) != marker; ++first) {
+    if (*first == '.') { before_point = false; continue; }
+    if (*first == '-') { continue; }
+    significant = significant || *first != '0';
+    if (before_point && significant) { ++scale; }
+    if (!before_point && !significant) { --scale; }
+  }
+  if (hex) { scale *= 4; }
+  if (first == last) { return scale > 0; }
+  ++first;
+  if (first != last && *first == '+') { ++first; }
+  long long exponent = 0;
+  if (std::from_chars(first, last, exponent).ec == std::errc::result_out_of_range) {
+    exponent = (*first == '-') ? std::numeric_limits<long long>::min() / 2 : std::numeric_limits<long long>::max() / 2;
+  }
+  return scale + exponent > 0;
+}
+
+/* Numeric conversion in the manner of std::strtol and std::strtod: leading whitespace and a '+' before the number are skipped, conversion stops at the first character that is not part of the number, and zero is returned if no conversion could be performed. Hexadecimal floating point is accepted as by std::strtod, and values out of range saturate, integers to the minimum or maximum of T, and floating point to infinity or zero. */
+template <class T>
+T convert_leading(std::string_view str) noexcept {
+  static_assert(is_convertible_number_v<T>, "Unsupported type conversion");
+  STDX_INSTRUMENT_CALL(convert, str.size(), 1);
+  std::size_t pos = char_classes<char>::whitespace.find_first_not_of(str.data(), str.size());
+  if (pos == str.npos) { return T(); }
+  const char* first = str.data() + pos;
+  const char* last = str.data() + str.size();
+  // Only a '+' directly before the number is skipped, so "+-5" is not a number
+  if (*first == '+' && last - first > 1 && ((first[1] >= '0' && first[1] <= '9') || first[1] == '.')) { ++first; }
+  T value = T();
+  if constexpr (std::is_floating_point_v<T>) {
+    const bool negative = *first == '-';
+    const bool hex = last - first > 2 + negative && first[negative] == '0' && (first[negative + 1] | 0x20) == 'x';
+    const char* start = hex ? first + negative + 2 : first;
+    if (hex && *start == '-') { return T(); }
+    const std::from_chars_result result = std::from_chars(start, last, value, hex ? std::chars_format::hex : std::chars_format::general);
+    if (result.ec == std::errc::result_out_of_range) {
+      value = float_overflows(start, result.ptr, hex) ? std::numeric_limits<T>::infinity() : T(0);
+      return negative ? -value : value;
+    }
+    if (result.ec != std::errc()) { return T(); }
+    return (hex && negative) ? -value : value;
+  } else {
+    const std::from_chars_result result = std::from_chars(first, last, value);
+    if (result.ec == std::errc::result_out_of_range) {
+      return *first == '-' ? std::numeric_limits<T>::min() : std::numeric_limits<T>::max();
+    }
+    if (result.ec != std::errc()) { return T(); }
+    return value;
+  }
+}
+
+}
+
+/* Python-like operations on string views
+ * These never allocate, except join: results are views of, or tokens referring into, the characters of the argument, which must outlive them. The rules are the same as for the members of basic_string of the same name. */
+/** Strip leading characters
+ *  Returns the part of \p str after any leading characters in the class \p chars. Defaults to stripping whitespace.
+ */
+template <class CharT, class Traits>
+std::basic_string_view<CharT, Traits> lstrip(std::basic_string_view<CharT, Traits> str,
+                                             const detail::nondeduced_t<basic_char_class<CharT>>& chars = char_classes<CharT>::whitespace) noexcept {
+  const std::size_t pos = chars.find_first_not_of(str.data(), str.size());
+  return detail::count_strip(str, str.substr(pos == str.npos ? str.size() : pos));
+}
+/** Strip leading characters
+ *  Returns the part of \p str after any leading characters given in \p chars.
+ */
+template <class CharT, class Traits>
+std::basic_string_view<CharT, Traits> lstrip(std::basic_string_view<CharT, Traits> str, detail::nondeduced_t<std::basic_string_view<CharT, Traits>> chars) noexcept {
+  const std::size_t pos = str.find_first_not_of(chars);
+  return detail::count_strip(str, str.substr(pos == str.npos ? str.size() : pos));
+}
+/** Strip trailing characters
+ *  Returns the part of \p str before any trailing characters in the class \p chars. Defaults to stripping whitespace.
+ */
+template <class CharT, class Traits>
+std::basic_string_view<CharT, Traits> rstrip(std::basic_string_view<CharT, Traits> str,
+                                             const detail::nondeduced_t<basic_char_class<CharT>>& chars = char_classes<CharT>::whitespace) noexcept {
+  const std::size_t pos = chars.find_last_not_of(str.data(), str.size());
+  return detail::count_strip(str, str.substr(0, pos == str.npos ? 0 : pos + 1));
+}
+/** Strip trailing characters
+ *  Returns the part of \p str before any trailing characters given in \p chars.
+ */
+template <class CharT, class Traits>
+std::basic_string_view<CharT, Traits> rstrip(std::basic_string_view<CharT, Traits> str, detail::nondeduced_t<std::basic_string_view<CharT, Traits>> chars) noexcept {
+  const std::size_t pos = str.find_last_not_of(chars);
+  return detail::count_strip(str, str.substr(0, pos == str.npos ? 0 : pos + 1));
+}
+/** Strip leading and trailing characters
+ *  Returns the part of \p str between any leading and trailing characters in the class \p chars. Defaults to stripping whitespace.
+ */
+template <class CharT, class Traits>
+std::basic_string_view<CharT, Traits> strip(std::basic_string_view<CharT, Traits> str,
+                                            const detail::nondeduced_t<basic_char_class<CharT>>& chars = char_classes<CharT>::whitespace) noexcept {
+  const std::size_t right = chars.find_last_not_of(str.data(), str.size());
+  // If right == npos, then left will be too
+  if (right == str.npos) { return detail::count_strip(str, str.substr(0, 0)); }
+  const std::size_t left = chars.find_first_not_of(str.data(), right + 1);
+  return detail::count_strip(str, str.substr(left, right + 1 - left));
+}
+/** Strip leading and trailing characters
+ *  Returns the part of \p str between any leading and trailing characters given in \p chars.
+ */
+template <class CharT, class Traits>
+std::basic_string_view<CharT, Traits> strip(std::basic_string_view<CharT, Traits> str, detail::nondeduced_t<std::basic_string_view<CharT, Traits>> chars) noexcept {
+  const std::size_t right = str.find_last_not_of(chars);
+  if (right == str.npos) { return detail::count_strip(str, str.substr(0, 0)); }
+  const std::size_t left = str.find_first_not_of(chars);
+  return detail::count_strip(str, str.substr(left, right + 1 - left));
+}
+/** Strip leading Unicode whitespace from the UTF-8 text \p str. See utf8_lstrip. */
+inline std::string_view lstrip(std::string_view str, utf8_whitespace_t) noexcept { return detail::count_strip(str, utf8_lstrip(str)); }
+/** Strip trailing Unicode whitespace from the UTF-8 text \p str. See utf8_rstrip. */
+inline std::string_view rstrip(std::string_view str, utf8_whitespace_t) noexcept { return detail::count_strip(str, utf8_rstrip(str)); }
+/** Strip leading and trailing Unicode whitespace from the UTF-8 text \p str. See utf8_strip. */
+inline std::string_view strip(std::string_view str, utf8_whitespace_t) noexcept { return detail::count_strip(str, utf8_strip(str)); }
+
+/** Lazily split \p str into tokens given a separator character. See basic_split_view. */
+template <class CharT, class Traits>
+basic_split_view<CharT, Traits> split_lazy(std::basic_string_view<CharT, Traits> str, detail::nondeduced_t<CharT> separator = static_cast<CharT>(-1),
+                                           bool treat_consecutive_as_one = true, std::size_t maxsplit = std::basic_string_view<CharT, Traits>::npos) noexcept {
+  return basic_split_view<CharT, Traits>(str, separator, treat_consecutive_as_one, maxsplit);
+}
+/** Lazily split \p str into tokens given a class of separator characters, which must outlive the result. See basic_split_view. */
+template <class CharT, class Traits>
+basic_split_view<CharT, Traits> split_lazy(std::basic_string_view<CharT, Traits> str, const detail::nondeduced_t<basic_char_class<CharT>>& separators,
+                                           bool treat_consecutive_as_one = true, std::size_t maxsplit = std::basic_string_view<CharT, Traits>::npos) noexcept {
+  return basic_split_view<CharT, Traits>(str, separators, treat_consecutive_as_one, maxsplit);
+}
+template <class CharT, class Traits>
+void split_lazy(std::basic_string_view<CharT, Traits>, const detail::nondeduced_t<basic_char_class<CharT>>&&, bool = true, std::size_t = 0) = delete;
+/** Lazily split the UTF-8 text \p str at Unicode whitespace. See utf8_split_view. */
+inline utf8_split_view split_lazy(std::string_view str, utf8_whitespace_t) noexcept { return utf8_split_view(str); }
+/** Lazily split \p str into tokens given a separator character, starting from the end. Tokens are yielded from right to left. */
+template <class CharT, class Traits>
+basic_split_view<CharT, Traits> rsplit_lazy(std::basic_string_view<CharT, Traits> str, detail::nondeduced_t<CharT> separator = static_cast<CharT>(-1),
+                                            bool treat_consecutive_as_one = true, std::size_t maxsplit = std::basic_string_view<CharT, Traits>::npos) noexcept {
+  return basic_split_view<CharT, Traits>(str, separator, treat_consecutive_as_one, maxsplit, true);
+}
+/** Lazily split \p str into tokens given a class of separator characters, which must outlive the result, starting from the end. */
+template <class CharT, class Traits>
+basic_split_view<CharT, Traits> rsplit_lazy(std::basic_string_view<CharT, Traits> str, const detail::nondeduced_t<basic_char_class<CharT>>& separators,
+                                            bool treat_consecutive_as_one = true, std::size_t maxsplit = std::basic_string_view<CharT, Traits>::npos) noexcept {
+  return basic_split_view<CharT, Traits>(str, separators, treat_consecutive_as_one, maxsplit, true);
+}
+template <class CharT, class Traits>
+void rsplit_lazy(std::basic_string_view<CharT, Traits>, const detail::nondeduced_t<basic_char_class<CharT>>&&, bool = true, std::size_t = 0) = delete;
+/** Split a string into tokens given a separator character.
+ *  Writes a std::basic_string_view of each token of \p str to \p out. See basic_split_view for the splitting rules.
+ */
+template <class CharT, class Traits, class OutputIt>
+void split(std::basic_string_view<CharT, Traits> str, OutputIt out, detail::nondeduced_t<CharT> separator = static_cast<CharT>(-1), bool treat_consecutive_as_one = true) {
+  STDX_INSTRUMENT_CALL(split, str.size(), sizeof(CharT));
+  for (auto token : basic_split_view<CharT, Traits>(str, separator, treat_consecutive_as_one)) {
+    *out = token;
+    ++out;
+  }
+}
+/** Split a string into tokens given a class of separator characters. */
+template <class CharT, class Traits, class OutputIt>
+void split(std::basic_string_view<CharT, Traits> str, OutputIt out, const detail::nondeduced_t<basic_char_class<CharT>>& separators, bool treat_consecutive_as_one = true) {
+  STDX_INSTRUMENT_CALL(split, str.size(), sizeof(CharT));
+  for (auto token : basic_split_view<CharT, Traits>(str, separators, treat_consecutive_as_one)) {
+    *out = token;
+    ++out;
+  }
+}
+/** Split the UTF-8 text \p str at Unicode whitespace. */
+template <class OutputIt>
+void split(std::string_view str, OutputIt out, utf8_whitespace_t) {
+  STDX_INSTRUMENT_CALL(split, str.size(), 1);
+  for (auto token : utf8_split_view(str)) {
+    *out = token;
+    ++out;
+  }
+}
+
+/** Concatenate a range of elements into a string or builder.
+ *  Appends the elements of [\p first, \p last) to \p out, separated by \p divider. Elements may be anything convertible to a string view, characters, or numbers (formatted by std::to_chars). \p out may be a basic_string_builder or a basic_inline_string, or any type with view_type, size, reserve, append and push_back members like theirs. For forward ranges of strings and characters, the total length is computed first and reserved, so \p out grows at most once, and a basic_inline_string which is too short throws before anything is appended.
+ */
+template <class Builder, class InputIt>
+Builder& join_into(Builder& out, typename Builder::view_type divider, InputIt first, InputIt last) {
+  using char_type = typename Builder::view_type::value_type;
+  using traits = typename Builder::view_type::traits_type;
+  using view_type = std::basic_string_view<char_type, traits>;
+  using element_type = std::remove_cv_t<std::remove_reference_t<decltype(*first)>>;
+  using category = typename std::iterator_traits<InputIt>::iterator_category;
+  const std::size_t start = out.size();
+  if constexpr (std::is_base_of_v<std::forward_iterator_tag, category>
+                && (std::is_same_v<element_type, char_type> || detail::is_string_like_v<element_type, char_type, traits>)) {
+    std::size_t total_length = 0, count = 0;
+    for (InputIt it = first; it != last; ++it, ++count) {
+      if constexpr (std::is_same_v<element_type, char_type>) { ++total_length; }
+      else { total_length += view_type(*it).size(); }
+    }
+    if (count > 0) { out.reserve(start + total_length + (count - 1) * divider.size()); }
+  }
+  if (first != last) {
+    detail::append_joined<char_type, traits>(out, *first);
+    for (++first; first != last; ++first) {
+      out.append(view_type(divider));
+      detail::append_joined<char_type, traits>(out, *first);
+    }
+  }
+  STDX_INSTRUMENT_CALL(join, out.size() - start, sizeof(char_type));
+  return out;
+}
+/** Concatenate the elements of [\p first, \p last) into a new string, separated by \p divider. See join_into. */
+template <class CharT, class Traits, class InputIt>
+std::basic_string<CharT, Traits> join(std::basic_string_view<CharT, Traits> divider, InputIt first, InputIt last) {
+  basic_string_builder<CharT, Traits> builder;
+  std::basic_string<CharT, Traits> result = join_into(builder, divider, first, last).take();
+  STDX_INSTRUMENT_STRING(join, result);
+  return result;
+}
+/** Concatenate the elements of \p range into a new string, separated by \p divider. */
+template <class CharT, class Traits, class Range>
+std::basic_string<CharT, Traits> join(std::basic_string_view<CharT, Traits> divider, const Range& range) {
+  using std::begin;
+  using std::end;
+  return join(divider, begin(range), end(range));
+}
+
+template <class CharT, class Traits>
+class basic_string_view_ex;
+template <class CharT, std::size_t N, class Traits>
+class basic_inline_string;
+
+namespace detail {
+
+template <class T>
+constexpr bool is_inline_string_v = false;
+template <class CharT, std::size_t N, class Traits>
+constexpr bool is_inline_string_v<basic_inline_string<CharT, N, Traits>> = true;
+
+}
+
+/** Python-like string operations for a contiguous range of characters, as a CRTP base class.
+ 
+ Adds strip, split, join and convert to any class Derived with data() and size() members, with the same rules as the members of basic_string of the same name. The operations do not copy: strips return a basic_string_view_ex of the kept characters, so operations can be chained, and splits produce std::basic_string_view tokens, so this must outlive the results. Only join allocates, returning a new std::basic_string. The operations are also available as free functions taking a std::basic_string_view.
+ 
+ \tparam Derived class deriving from basic_string_algorithms
+ \tparam CharT character type.
+ \tparam Traits traits class specifying the operations on the character type
+ */
+template <class Derived, class CharT, class Traits = std::char_traits<CharT>>
+class basic_string_algorithms {
+public:
+  /* Member types */
+  using view_type = basic_string_view_ex<CharT, Traits>;
+  using split_view_type = basic_split_view<CharT, Traits>;
+  using char_class_type = basic_char_class<CharT>;
+  
+  /** Strip leading characters
+   *  Returns a view without any leading characters in the class \p chars. Defaults to stripping whitespace.
+   */
+  view_type lstrip(const char_class_type& chars = char_classes<CharT>::whitespace) const noexcept { return stdx::lstrip(whole(), chars); }
+  /** Strip leading characters given in \p chars. */
+  view_type lstrip(std::basic_string_view<CharT, Traits> chars) const noexcept { return stdx::lstrip(whole(), chars); }
+  /** Strip leading Unicode whitespace from UTF-8 text. */
+  view_type lstrip(utf8_whitespace_t) const noexcept { return stdx::lstrip(utf8_whole(), utf8_whitespace); }
+  /** Strip trailing characters
+   *  Returns a view without any trailing characters in the class \p chars. Defaults to stripping whitespace.
+   */
+  view_type rstrip(const char_class_type& chars = char_classes<CharT>::whitespace) const noexcept { return stdx::rstrip(whole(), chars); }
+  /** Strip trailing characters given in \p chars. */
+  view_type rstrip(std::basic_string_view<CharT, Traits> chars) const noexcept { return stdx::rstrip(whole(), chars); }
+  /** Strip trailing Unicode whitespace from UTF-8 text. */
+  view_type rstrip(utf8_whitespace_t) const noexcept { return stdx::rstrip(utf8_whole(), utf8_whitespace); }
+  /** Strip leading and trailing characters
+   *  Returns a view without any leading and trailing characters in the class \p chars. Defaults to stripping whitespace.
+   */
+  view_type strip(const char_class_type& chars = char_classes<CharT>::whitespace) const noexcept { return stdx::strip(whole(), chars); }
+  /** Strip leading and trailing characters given in \p chars. */
+  view_type strip(std::basic_string_view<CharT, Traits> chars) const noexcept { return stdx::strip(whole(), chars); }
+  /** Strip leading and trailing Unicode whitespace from UTF-8 text. */
+  view_type strip(utf8_whitespace_t) const noexcept { return stdx::strip(utf8_whole(), utf8_whitespace); }
+  
+  /** Split into tokens given a separator character, writing a view of each token to \p out. */
+  template <typename OutputIt>
+  void split(OutputIt out, CharT separator = static_cast<CharT>(-1), bool treat_consecutive_as_one = true) const {
+    stdx::split(whole(), out, separator, treat_consecutive_as_one);
+  }
+  /** Split into tokens given a class of separator characters, writing a view of each token to \p out. */
+  template <typename OutputIt>
+  void split(OutputIt out, const char_class_type& separators, bool treat_consecutive_as_one = true) const {
+    stdx::split(whole(), out, separators, treat_consecutive_as_one);
+  }
+  /** Split UTF-8 text at Unicode whitespace, writing a view of each token to \p out. */
+  template <typename OutputIt>
+  void split(OutputIt out, utf8_whitespace_t) const { stdx::split(utf8_whole(), out, utf8_whitespace); }
+  /** Lazily split into tokens given a separator character. */
+  split_view_type split_lazy(CharT separator = static_cast<CharT>(-1), bool treat_consecutive_as_one = true,
+                             std::size_t maxsplit = split_view_type::npos) const noexcept {
+    return stdx::split_lazy(whole(), separator, treat_consecutive_as_one, maxsplit);
+  }
+  /** Lazily split into tokens given a class of separator characters, which must outlive the result. */
+  split_view_type split_lazy(const char_class_type& separators, bool treat_consecutive_as_one = true, std::size_t maxsplit = split_view_type::npos) const noexcept {
+    return stdx::split_lazy(whole(), separators, treat_consecutive_as_one, maxsplit);
+  }
+  void split_lazy(const char_class_type&&, bool = true, std::size_t = 0) const = delete;
+  /** Lazily split UTF-8 text at Unicode whitespace. */
+  utf8_split_view split_lazy(utf8_whitespace_t) const noexcept { return utf8_split_view(utf8_whole()); }
+  /** Lazily split into tokens given a separator character, starting from the end. Tokens are yielded from right to left. */
+  split_view_type rsplit_lazy(CharT separator = static_cast<CharT>(-1), bool treat_consecutive_as_one = true,
+                              std::size_t maxsplit = split_view_type::npos) const noexcept {
+    return stdx::rsplit_lazy(whole(), separator, treat_consecutive_as_one, maxsplit);
+  }
+  /** Lazily split into tokens given a class of separator characters, which must outlive the result, starting from the end. */
+  split_view_type rsplit_lazy(const char_class_type& separators, bool treat_consecutive_as_one = true, std::size_t maxsplit = split_view_type::npos) const noexcept {
+    return stdx::rsplit_lazy(whole(), separators, treat_consecutive_as_one, maxsplit);
+  }
+  void rsplit_lazy(const char_class_type&&, bool = true, std::size_t = 0) const = delete;
+  
+  /** Concatenate a range of elements into a new string, using this as the divider. See join_into. */
+  template <typename InputIt>
+  std::basic_string<CharT, Traits> join(InputIt first, InputIt last) const { return stdx::join(whole(), first, last); }
+  /** Concatenate the elements of \p range into a new string, using this as the divider. */
+  template <typename Range>
+  std::basic_string<CharT, Traits> join(const Range& range) const { return stdx::join(whole(), range); }
+  
+  /** Convert to numeric type.
+   *  As with std::strtol, leading whitespace and a '+' before the number are skipped, and conversion stops at the first character that is not part of the number. Returns zero if no conversion could be performed, and saturates values out of range. See basic_string::convert.
+   */
+  template <typename T>
+  T convert() const noexcept {
+    static_assert(std::is_same_v<CharT, char>, "Numeric conversion is only supported for CharT = char");
+    return detail::convert_leading<T>(whole());
+  }
+  /** Convert to numeric type, reporting errors. The whole range must be a number in the format accepted by std::from_chars. See stdx::convert. */
+  template <typename T>
+  convert_result<T> try_convert() const noexcept {
+    static_assert(std::is_same_v<CharT, char>, "Numeric conversion is only supported for CharT = char");
+    return stdx::convert<T>(whole());
+  }
+  
+private:
+  std::basic_string_view<CharT, Traits> whole() const noexcept {
+    const Derived& self = static_cast<const Derived&>(*this);
+    return std::basic_string_view<CharT, Traits>(self.data(), self.size());
+  }
+  std::string_view utf8_whole() const noexcept {
+    static_assert(std::is_same_v<CharT, char>, "Unicode whitespace in UTF-8 is only supported for CharT = char");
+    return whole();
+  }
+};
+
+/** std::basic_string_view with the Python-like operations of basic_string_algorithms.
+ 
+ Can be constructed from anything convertible to std::basic_string_view, including stdx::basic_string and basic_inline_string, to strip, split or convert them without a copy. Strips return basic_string_view_ex, so operations can be chained, as in line.strip().split_lazy(',').
+ 
+ \tparam CharT character type.
+ \tparam Traits traits class specifying the operations on the character type
+ */
+template <class CharT, class Traits = std::char_traits<CharT>>
+class basic_string_view_ex : public std::basic_string_view<CharT, Traits>, public basic_string_algorithms<basic_string_view_ex<CharT, Traits>, CharT, Traits> {
+  using parent_type = std::basic_string_view<CharT, Traits>;
+public:
+  /* Member types */
+  using size_type = typename parent_type::size_type;
+  
+  static constexpr size_type npos = parent_type::npos;
+  
+  /* Constructors */
+  /** Default constructor. Constructs an empty view. */
+  constexpr basic_string_view_ex() noexcept = default;
+  /** Construct a view of the \p count characters pointed to by \p s. */
+  constexpr basic_string_view_ex(const CharT* s, size_type count) noexcept : parent_type(s, count) { }
+  /** Construct a view of the null terminated string \p s. */
+  constexpr basic_string_view_ex(const CharT* s) noexcept : parent_type(s) { }
+  /** Construct a view of \p str, which may be anything convertible to std::basic_string_view. */
+  template <class T, class = std::enable_if_t<std::is_convertible_v<const T&, parent_type> && !std::is_convertible_v<const T&, const CharT*>>>
+  constexpr basic_string_view_ex(const T& str) : parent_type(str) { }
+  
+  /** Returns a view of the substring [\p pos, \p pos + \p count). If \p pos > size(), an exception of type std::out_of_range is thrown. */
+  constexpr basic_string_view_ex substr(size_type pos = 0, size_type count = npos) const { return parent_type::substr(pos, count); }
+};
+
+/** String with a fixed capacity of N characters, which never allocates.
+ 
+ The characters are stored in the object itself, followed by a null character, so short keys and fields can be created, copied and destroyed without touching the heap, and arrays of them are contiguous. The string is trivially copyable. Operations which would make it longer than N characters throw an exception of type std::length_error, and leave it unchanged.
+ 
+ Has the Python-like operations of basic_string_algorithms, which return views into this string, except join, which returns a basic_inline_string with the same capacity. A view of the string may be assigned back to it, so s = s.strip() strips inplace.
+ 
+ \tparam CharT character type.
+ \tparam N maximum number of characters
+ \tparam Traits traits class specifying the operations on the character type
+ */
+template <class CharT, std::size_t N, class Traits = std::char_traits<CharT>>
+class basic_inline_string : public basic_string_algorithms<basic_inline_string<CharT, N, Traits>, CharT, Traits> {
+  using string_view_type = std::basic_string_view<CharT, Traits>;
+  template <class T>
+  using enable_if_string_like = std::enable_if_t<detail::is_string_like_v<T, CharT, Traits> && !std::is_same_v<T, basic_inline_string>>;
+  template <class T>
+  using enable_if_comparable = std::enable_if_t<detail::is_string_like_v<T, CharT, Traits> && !detail::is_inline_string_v<T>>;
+public:
+  /* Member types */
+  using traits_type = Traits;
+  using value_type = CharT;
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+  using reference = CharT&;
+  using const_reference = const CharT&;
+  using pointer = CharT*;
+  using const_pointer = const CharT*;
+  using iterator = CharT*;
+  using const_iterator = const CharT*;
+  using reverse_iterator = std::reverse_iterator<iterator>;
+  using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+  using typename basic_string_algorithms<basic_inline_string<CharT, N, Traits>, CharT, Traits>::view_type;
+  
+  static constexpr size_type npos = static_cast<size_type>(-1);
+  
+  /* Constructors */
+  /** Default constructor. Constructs an empty string. */
+  basic_inline_string() noexcept : count(0) { chars[0] = CharT(); }
+  /** Construct with the \p n characters pointed to by \p s. */
+  basic_inline_string(const CharT* s, size_type n) : basic_inline_string() { assign(string_view_type(s, n)); }
+  /** Construct with \p n copies of \p ch. */
+  basic_inline_string(size_type n, CharT ch) : basic_inline_string() { assign(n, ch); }
+  /** Construct with the characters of \p str, which may be anything convertible to std::basic_string_view, including a null terminated string. */
+  template <class T, class = enable_if_string_like<T>>
+  basic_inline_string(const T& str) : basic_inline_string() { assign(string_view_type(str)); }
+  
+  /** Replace the contents with the characters of \p str. */
+  template <class T, class = enable_if_string_like<T>>
+  basic_inline_string& operator=(const T& str) { return assign(string_view_type(str)); }
+  /** Replace the contents with the characters of \p str, which may be a view of this string. */
+  basic_inline_string& assign(string_view_type str) {
+    check_length(str.size());
+    Traits::move(chars, str.data(), str.size());
+    set_size(str.size());
+    return *this;
+  }
+  /** Replace the contents with \p n copies of \p ch. */
+  basic_inline_string& assign(size_type n, CharT ch) {
+    check_length(n);
+    Traits::assign(chars, n, ch);
+    set_size(n);
+    return *this;
+  }
+  
+  /** Return a reference to the character at specified location \p pos, with bounds checking. If \p pos is not within the range of the string, an exception of type std::out_of_range is thrown. */
+  reference at(size_type pos) {
+    if (pos >= count) { throw std::out_of_range("basic_inline_string::at"); }
+    return chars[pos];
+  }
+  const_reference at(size_type pos) const {
+    if (pos >= count) { throw std::out_of_range("basic_inline_string::at"); }
+    return chars[pos];
+  }
+  /** Returns a reference to the character at specified location pos. No bounds checking is performed. */
+  reference operator[](size_type pos) noexcept { return chars[pos]; }
+  const_reference operator[](size_type pos) const noexcept { return chars[pos]; }
+  /** Returns a reference to the first character. Calling front on an empty string is undefined. */
+  reference front() noexcept { return chars[0]; }
+  const_reference front() const noexcept { return chars[0]; }
+  /** Returns a reference to the last character. Calling back on an empty string is undefined. */
+  reference back() noexcept { return chars[count - 1]; }
+  const_reference back() const noexcept { return chars[count - 1]; }
+  /** Returns a pointer to the characters, which are followed by a null character. */
+  CharT* data() noexcept { return chars; }
+  const CharT* data() const noexcept { return chars; }
+  const CharT* c_str() const noexcept { return chars; }
+  /** Returns a view of the characters. */
+  operator string_view_type() const noexcept { return string_view_type(chars, count); }
+  view_type view() const noexcept { return view_type(chars, count); }
+  
+  /** Iterators over the characters. */
+  iterator begin() noexcept { return chars; }
+  const_iterator begin() const noexcept { return chars; }
+  const_iterator cbegin() const noexcept { return chars; }
+  iterator end() noexcept { return chars + count; }
+  const_iterator end() const noexcept { return chars + count; }
+  const_iterator cend() const noexcept { return chars + count; }
+  reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+  const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+  const_reverse_iterator crbegin() const noexcept { return const_reverse_iterator(end()); }
+  reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+  const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+  const_reverse_iterator crend() const noexcept { return const_reverse_iterator(begin()); }
+  
+  /** Returns true if the string is empty. */
+  bool empty() const noexcept { return count == 0; }
+  /** Returns the number of characters. */
+  size_type size() const noexcept { return count; }
+  size_type length() const noexcept { return count; }
+  /** Returns the maximum number of characters, N. */
+  static constexpr size_type capacity() noexcept { return N; }
+  static constexpr size_type max_size() noexcept { return N; }
+  /** Check that \p n characters fit. Never allocates; if \p n > N, an exception of type std::length_error is thrown. */
+  void reserve(size_type n) const { check_length(n); }
+  
+  /** Remove all characters. */
+  void clear() noexcept { set_size(0); }
+  /** Append the character \p ch. */
+  basic_inline_string& push_back(CharT ch) {
+    check_length(count + 1);
+    chars[count] = ch;
+    set_size(count + 1);
+    return *this;
+  }
+  /** Remove the last character. Calling pop_back on an empty string is undefined. */
+  void pop_back() noexcept { set_size(count - 1); }
+  /** Append the characters of \p str. */
+  basic_inline_string& append(string_view_type str) {
+    if (str.size() > N - count) { throw_length_error(); }
+    Traits::copy(chars + count, str.data(), str.size());
+    set_size(count + str.size());
+    return *this;
+  }
+  /** Append \p n copies of \p ch. */
+  basic_inline_string& append(size_type n, CharT ch) {
+    if (n > N - count) { throw_length_error(); }
+    Traits::assign(chars + count, n, ch);
+    set_size(count + n);
+    return *this;
+  }
+  basic_inline_string& operator+=(string_view_type str) { return append(str); }
+  basic_inline_string& operator+=(CharT ch) { return push_back(ch); }
+  /** Resize to \p n characters, appending copies of \p ch if the string grows. */
+  void resize(size_type n, CharT ch = CharT()) {
+    check_length(n);
+    if (n > count) { Traits::assign(chars + count, n - count, ch); }
+    set_size(n);
+  }
+  
+  /** Concatenate a range of elements into a new basic_inline_string, using this as the divider. If the result would be longer than N, an exception of type std::length_error is thrown. See join_into. */
+  template <typename InputIt>
+  basic_inline_string join(InputIt first, InputIt last) const {
+    basic_inline_string result;
+    stdx::join_into(result, view(), first, last);
+    return result;
+  }
+  /** Concatenate the elements of \p range into a new basic_inline_string, using this as the divider. */
+  template <typename Range>
+  basic_inline_string join(const Range& range) const {
+    using std::begin;
+    using std::end;
+    return join(begin(range), end(range));
+  }
+  
+  /** Comparison with strings of any capacity, and anything convertible to std::basic_string_view. */
+  template <std::size_t M>
+  friend bool operator==(const basic_inline_string& lhs, const basic_inline_string<CharT, M, Traits>& rhs) noexcept { return string_view_type(lhs) == string_view_type(rhs); }
+  template <class T, class = enable_if_comparable<T>>
+  friend bool operator==(const basic_inline_string& lhs, const T& rhs) noexcept { return string_view_type(lhs) == string_view_type(rhs); }
+  template <class T, class = enable_if_comparable<T>>
+  friend bool operator==(const T& lhs, const basic_inline_string& rhs) noexcept { return string_view_type(lhs) == string_view_type(rhs); }
+  template <std::size_t M>
+  friend bool operator!=(const basic_inline_string& lhs, const basic_inline_string<CharT, M, Traits>& rhs) noexcept { return string_view_type(lhs) != string_view_type(rhs); }
+  template <class T, class = enable_if_comparable<T>>
+  friend bool operator!=(const basic_inline_string& lhs, const T& rhs) noexcept { return string_view_type(lhs) != string_view_type(rhs); }
+  template <class T, class = enable_if_comparable<T>>
+  friend bool operator!=(const T& lhs, const basic_inline_string& rhs) noexcept { return string_view_type(lhs) != string_view_type(rhs); }
+  template <std::size_t M>
+  friend bool operator<(const basic_inline_string& lhs, const basic_inline_string<CharT, M, Traits>& rhs) noexcept { return string_view_type(lhs) < string_view_type(rhs); }
+  template <class T, class = enable_if_comparable<T>>
+  friend bool operator<(const basic_inline_string& lhs, const T& rhs) noexcept { return string_view_type(lhs) < string_view_type(rhs); }
+  template <class T, class = enable_if_comparable<T>>
+  friend bool operator<(const T& lhs, const basic_inline_string& rhs) noexcept { return string_view_type(lhs) < string_view_type(rhs); }
+  template <std::size_t M>
+  friend bool operator<=(const basic_inline_string& lhs, const basic_inline_string<CharT, M, Traits>& rhs) noexcept { return string_view_type(lhs) <= string_view_type(rhs); }
+  template <class T, class = enable_if_comparable<T>>
+  friend bool operator<=(const basic_inline_string& lhs, const T& rhs) noexcept { return string_view_type(lhs) <= string_view_type(rhs); }
+  template <class T, class = enable_if_comparable<T>>
+  friend bool operator<=(const T& lhs, const basic_inline_string& rhs) noexcept { return string_view_type(lhs) <= string_view_type(rhs); }
+  template <std::size_t M>
+  friend bool operator>(const basic_inline_string& lhs, const basic_inline_string<CharT, M, Traits>& rhs) noexcept { return string_view_type(lhs) > string_view_type(rhs); }
+  template <class T, class = enable_if_comparable<T>>
+  friend bool operator>(const basic_inline_string& lhs, const T& rhs) noexcept { return string_view_type(lhs) > string_view_type(rhs); }
+  template <class T, class = enable_if_comparable<T>>
+  friend bool operator>(const T& lhs, const basic_inline_string& rhs) noexcept { return string_view_type(lhs) > string_view_type(rhs); }
+  template <std::size_t M>
+  friend bool operator>=(const basic_inline_string& lhs, const basic_inline_string<CharT, M, Traits>& rhs) noexcept { return string_view_type(lhs) >= string_view_type(rhs); }
+  template <class T, class = enable_if_comparable<T>>
+  friend bool operator>=(const basic_inline_string& lhs, const T& rhs) noexcept { return string_view_type(lhs) >= string_view_type(rhs); }
+  template <class T, class = enable_if_comparable<T>>
+  friend bool operator>=(const T& lhs, const basic_inline_string& rhs) noexcept { return string_view_type(lhs) >= string_view_type(rhs); }
+  
+  friend std::basic_ostream<CharT, Traits>& operator<<(std::basic_ostream<CharT, Traits>& os, const basic_inline_string& str) { return os << string_view_type(str); }
+  
+private:
+  /* The throw is kept out of line, so the check inlines and the compiler sees that nothing after a failed check runs. */
+  static void check_length(size_type n) {
+    if (n > N) { throw_length_error(); }
+  }
+  [[noreturn]] static void throw_length_error() { throw std::length_error("basic_inline_string: capacity exceeded"); }
+  void set_size(size_type n) noexcept {
+    count = n;
+    chars[n] = CharT();
+  }
+  
+  size_type count;
+  CharT chars[N + 1];
+};
+
+/** Typedefs for common character types **/
+using split_view = basic_split_view<char>;
+using wsplit_view = basic_split_view<wchar_t>;
+using u16split_view = basic_split_view<char16_t>;
+using u32split_view = basic_split_view<char32_t>;
+
+using string_view_ex = basic_string_view_ex<char>;
+using wstring_view_ex = basic_string_view_ex<wchar_t>;
+using u16string_view_ex = basic_string_view_ex<char16_t>;
+using u32string_view_ex = basic_string_view_ex<char32_t>;
+
+template <std::size_t N>
+using inline_string = basic_inline_string<char, N>;
+template <std::size_t N>
+using winline_string = basic_inline_string<wchar_t, N>;
+template <std::size_t N>
+using u16inline_string = basic_inline_string<char16_t, N>;
+template <std::size_t N>
+using u32inline_string = basic_inline_string<char32_t, N>;
+
+}
+
+namespace std {
+/** Hash of a basic_inline_string, equal to the hash of its characters as a std::basic_string_view. */
+template <class CharT, std::size_t N, class Traits>
+struct hash<stdx::basic_inline_string<CharT, N, Traits>> {
+  std::size_t operator()(const stdx::basic_inline_string<CharT, N, Traits>& str) const noexcept {
+    return std::hash<std::basic_string_view<CharT, Traits>>()(std::basic_string_view<CharT, Traits>(str));
+  }
+};
+}
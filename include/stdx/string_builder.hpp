@@ -0,0 +1,138 @@
+#pragma once
+
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+namespace stdx {
+
+namespace detail {
+
+template <class T, class CharT, class Traits>
+constexpr bool is_string_like_v = std::is_convertible_v<const T&, std::basic_string_view<CharT, Traits>>;
+
+template <class T, class CharT>
+constexpr bool is_number_like_v = std::is_arithmetic_v<T> && !std::is_same_v<T, bool> && !std::is_same_v<T, CharT>;
+
+}
+
+/** Builder for strings assembled from many pieces.
+
+ Pieces (strings, string views, characters and numbers) are appended directly into a single buffer, without creating temporary strings. Numbers are formatted with std::to_chars, so formatting does not depend on the current locale. The buffer grows geometrically, and can be reserved up front when the final size is known, in which case building the string allocates exactly once. The result is moved out with take, without copying.
+
+ \tparam CharT character type.
+ \tparam Traits traits class specifying the operations on the character type
+ \tparam Allocator Allocator type used to allocate internal storage
+ */
+template <class CharT, class Traits = std::char_traits<CharT>, class Allocator = std::allocator<CharT>>
+class basic_string_builder {
+public:
+  /* Member types */
+  using string_type = std::basic_string<CharT, Traits, Allocator>;
+  using view_type = std::basic_string_view<CharT, Traits>;
+  using size_type = typename string_type::size_type;
+  using allocator_type = Allocator;
+
+  /* Constructors */
+  /** Default constructor.
+   *  Constructs an empty builder. If no allocator is supplied, allocator is obtained from a default-constructed instance.
+   */
+  basic_string_builder() noexcept(noexcept(Allocator())) : buffer() { }
+  explicit basic_string_builder(const Allocator& alloc) noexcept : buffer(alloc) { }
+  /** Construct an empty builder with storage reserved for \p capacity characters. */
+  explicit basic_string_builder(size_type capacity, const Allocator& alloc = Allocator()) : buffer(alloc) { buffer.reserve(capacity); }
+
+  /** Append the characters of \p str. */
+  basic_string_builder& append(view_type str) {
+    grow_for(str.size());
+    buffer.append(str.data(), str.size());
+    return *this;
+  }
+  /** Append the \p count characters pointed to by \p s. */
+  basic_string_builder& append(const CharT* s, size_type count) { return append(view_type(s, count)); }
+  /** Append \p count copies of \p ch. */
+  basic_string_builder& append(size_type count, CharT ch) {
+    grow_for(count);
+    buffer.append(count, ch);
+    return *this;
+  }
+  /** Append the character \p ch. */
+  basic_string_builder& push_back(CharT ch) {
+    grow_for(1);
+    buffer.push_back(ch);
+    return *this;
+  }
+  /** Append the decimal representation of \p value, as formatted by std::to_chars. */
+  template <class T>
+  basic_string_builder& append_number(T value) {
+    static_assert(std::is_arithmetic_v<T> && !std::is_same_v<T, bool>, "Unsupported number type");
+    char digits[128];
+    auto result = std::to_chars(digits, digits + sizeof(digits), value);
+    const size_type count = static_cast<size_type>(result.ptr - digits);
+    grow_for(count);
+    if constexpr (std::is_same_v<CharT, char>) {
+      buffer.append(digits, count);
+    } else {
+      for (size_type i = 0; i < count; ++i) { buffer.push_back(static_cast<CharT>(digits[i])); }
+    }
+    return *this;
+  }
+
+  /** Append \p value, which may be a character, anything convertible to a string view, or a number. */
+  template <class T>
+  basic_string_builder& operator<<(const T& value) {
+    if constexpr (std::is_same_v<T, CharT>) { return push_back(value); }
+    else if constexpr (detail::is_string_like_v<T, CharT, Traits>) { return append(view_type(value)); }
+    else if constexpr (detail::is_number_like_v<T, CharT>) { return append_number(value); }
+    else {
+      static_assert(std::is_same_v<T, CharT>, "Unsupported type for string_builder");
+      return *this;
+    }
+  }
+
+  /** Reserve storage for at least \p capacity characters in total. */
+  void reserve(size_type capacity) { buffer.reserve(capacity); }
+  /** Remove all characters, keeping the storage. */
+  void clear() noexcept { buffer.clear(); }
+
+  /** Returns the number of characters appended so far. */
+  size_type size() const noexcept { return buffer.size(); }
+  /** Returns the number of characters that can be held without reallocating. */
+  size_type capacity() const noexcept { return buffer.capacity(); }
+  /** Returns true if no characters have been appended. */
+  bool empty() const noexcept { return buffer.empty(); }
+  /** Returns a view of the characters appended so far. Invalidated by any further appends. */
+  view_type view() const noexcept { return view_type(buffer); }
+  /** Returns a copy of the characters appended so far. */
+  string_type str() const { return buffer; }
+  /** Move the built string out of the builder, leaving the builder empty. */
+  string_type take() noexcept {
+    string_type result(std::move(buffer));
+    buffer.clear();
+    return result;
+  }
+
+  /** Returns the allocator associated with the builder. */
+  allocator_type get_allocator() const noexcept { return buffer.get_allocator(); }
+
+private:
+  void grow_for(size_type count) {
+    const size_type required = buffer.size() + count;
+    if (required > buffer.capacity()) { buffer.reserve(std::max(required, buffer.capacity() * 2)); }
+  }
+
+  string_type buffer;
+};
+
+/** Typedefs for common character types **/
+using string_builder = basic_string_builder<char>;
+using wstring_builder = basic_string_builder<wchar_t>;
+using u16string_builder = basic_string_builder<char16_t>;
+using u32string_builder = basic_string_builder<char32_t>;
+
+}
@@ -0,0 +1,436 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <shared_mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "common.hpp"
+
+namespace stdx {
+
+namespace detail {
+
+/** Append-only character storage, allocated in chunks which are never moved, so views into it remain valid until it is destroyed. */
+template <class CharT, class Allocator>
+class chunk_store {
+  using chunk_type = std::vector<CharT, Allocator>;
+  using chunk_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<chunk_type>;
+
+public:
+  static constexpr std::size_t chunk_size = 65536 / sizeof(CharT);
+
+  explicit chunk_store(const Allocator& alloc) : alloc(alloc), chunks(chunk_allocator(alloc)) { }
+
+  /** Copy the \p count characters pointed to by \p s into the store, and return a pointer to the copy. */
+  const CharT* store(const CharT* s, std::size_t count) {
+    if (chunks.empty() || chunks.back().capacity() - chunks.back().size() < count) {
+      chunks.push_back(chunk_type(alloc));
+      chunks.back().reserve(std::max(chunk_size, count));
+    }
+    chunk_type& chunk = chunks.back();
+    const CharT* copy = chunk.data() + chunk.size();
+    chunk.insert(chunk.end(), s, s + count);
+    return copy;
+  }
+  void clear() noexcept { chunks.clear(); }
+
+private:
+  Allocator alloc;
+  std::vector<chunk_type, chunk_allocator> chunks;
+};
+
+/** Hash of the code units of \p str. */
+template <class CharT, class Traits>
+inline std::size_t hash_code_units(std::basic_string_view<CharT, Traits> str) noexcept {
+  return std::hash<std::basic_string_view<CharT>>()(std::basic_string_view<CharT>(str.data(), str.size()));
+}
+
+}
+
+/** Pool of interned strings. Each distinct string added to the pool is stored once, and given a dense integer id, numbered from zero in order of first addition.
+
+ Strings are copied into chunks of storage obtained from the allocator, so views of interned strings remain valid for the lifetime of the pool, and interning a string already in the pool costs one hash lookup and no allocation. Comparing ids is equivalent to comparing the strings. With a pmr allocator, for example from stdx::pmr::arena, all storage comes from the given memory resource.
+
+ The pool is not thread safe; see basic_concurrent_string_pool.
+
+ \tparam CharT character type.
+ \tparam Traits traits class specifying the operations on the character type
+ \tparam Allocator Allocator type used to allocate internal storage
+ */
+template <class CharT, class Traits = std::char_traits<CharT>, class Allocator = std::allocator<CharT>>
+class basic_string_pool {
+  template <class T>
+  using rebind = typename std::allocator_traits<Allocator>::template rebind_alloc<T>;
+
+public:
+  /* Member types */
+  using view_type = std::basic_string_view<CharT, Traits>;
+  using size_type = std::size_t;
+  using id_type = std::uint32_t;
+  using allocator_type = Allocator;
+
+  /* Static constants */
+  /** Id returned by find for strings not in the pool. */
+  static constexpr id_type npos = static_cast<id_type>(-1);
+
+  /* Constructors */
+  /** Default constructor.
+   *  Constructs an empty pool. If no allocator is supplied, allocator is obtained from a default-constructed instance.
+   */
+  basic_string_pool() : basic_string_pool(Allocator()) { }
+  explicit basic_string_pool(const Allocator& alloc)
+  : store(alloc), entries(rebind<view_type>(alloc)), hashes(rebind<std::size_t>(alloc)), slots(rebind<id_type>(alloc)), mask(0) { }
+
+  basic_string_pool(const basic_string_pool&) = delete;
+  basic_string_pool& operator=(const basic_string_pool&) = delete;
+  /** Move constructor. Views of strings in \p other remain valid. */
+  basic_string_pool(basic_string_pool&&) = default;
+
+  /** Returns the allocator associated with the pool. */
+  allocator_type get_allocator() const noexcept { return allocator_type(entries.get_allocator()); }
+
+  /** Add \p str to the pool if it is not already there, and return its id. If the pool already holds npos strings, an exception of type std::length_error is thrown. */
+  id_type intern(view_type str) {
+    if ((entries.size() + 1) * 2 > slots.size()) { grow(); }
+    const std::size_t hash = detail::hash_code_units(str);
+    std::size_t slot = probe(str, hash);
+    if (slots[slot] != 0) { return slots[slot] - 1; }
+    if (entries.size() >= npos) { throw std::length_error("basic_string_pool::intern"); }
+    const id_type id = static_cast<id_type>(entries.size());
+    entries.push_back(view_type(store.store(str.data(), str.size()), str.size()));
+    hashes.push_back(hash);
+    slots[slot] = id + 1;
+    return id;
+  }
+  /** Returns the id of \p str, or npos if it is not in the pool. */
+  id_type find(view_type str) const noexcept {
+    if (slots.empty()) { return npos; }
+    const id_type found = slots[probe(str, detail::hash_code_units(str))];
+    return found == 0 ? npos : found - 1;
+  }
+  /** Returns true if \p str is in the pool. */
+  bool contains(view_type str) const noexcept { return find(str) != npos; }
+
+  /** Returns a view of the string with id \p id. No bounds checking is performed. */
+  view_type operator[](id_type id) const noexcept { return entries[id]; }
+  /** Returns a view of the string with id \p id, with bounds checking. If \p id is not in the pool, an exception of type std::out_of_range is thrown. */
+  view_type at(id_type id) const {
+    if (id >= entries.size()) { throw std::out_of_range("basic_string_pool::at"); }
+    return entries[id];
+  }
+
+  /** Returns the number of strings in the pool. */
+  size_type size() const noexcept { return entries.size(); }
+  /** Returns true if the pool is empty. */
+  bool empty() const noexcept { return entries.empty(); }
+  /** Reserve space for \p count strings, so that interning them does not rehash. */
+  void reserve(size_type count) {
+    entries.reserve(count);
+    hashes.reserve(count);
+    while (count * 2 > slots.size()) { grow(); }
+  }
+  /** Remove all strings from the pool, invalidating all ids and views. */
+  void clear() noexcept {
+    store.clear();
+    entries.clear();
+    hashes.clear();
+    std::fill(slots.begin(), slots.end(), 0);
+  }
+
+private:
+  /** Returns the slot holding \p str, or the empty slot where it would be inserted. */
+  std::size_t probe(view_type str, std::size_t hash) const noexcept {
+    std::size_t slot = hash & mask;
+    for (; slots[slot] != 0; slot = (slot + 1) & mask) {
+      const id_type id = slots[slot] - 1;
+      if (hashes[id] == hash && entries[id] == str) { break; }
+    }
+    return slot;
+  }
+  void grow() {
+    const std::size_t size = slots.empty() ? 64 : slots.size() * 2;
+    slots.assign(size, 0);
+    mask = size - 1;
+    for (id_type id = 0; id < entries.size(); ++id) {
+      std::size_t slot = hashes[id] & mask;
+      while (slots[slot] != 0) { slot = (slot + 1) & mask; }
+      slots[slot] = id + 1;
+    }
+  }
+
+  detail::chunk_store<CharT, Allocator> store;
+  std::vector<view_type, rebind<view_type>> entries;    // Indexed by id
+  std::vector<std::size_t, rebind<std::size_t>> hashes; // Indexed by id
+  std::vector<id_type, rebind<id_type>> slots;          // Open addressing table of id + 1, or 0 if empty
+  std::size_t mask;
+};
+
+/** Pool of interned strings which many threads can use at the same time.
+
+ As basic_string_pool, with ids dense across the whole pool. Strings are divided between shards by hash, each with its own table, storage and reader-writer lock, so threads looking up strings already in the pool take shared locks and do not block each other, and threads adding strings only contend when they add to the same shard. Views of the strings are held in a table divided into segments of doubling size, which are never moved, so looking up a string by id takes no lock.
+
+ An id may be passed to at or operator[] by the thread that obtained it from intern or find, by any thread that synchronises with that thread afterwards, or by any thread once it is below size(). Ids are published in order, so size() only counts a string once all strings with lower ids can be read. A thread adding a string publishes its id after releasing the shard lock, and intern and find wait, holding no lock, for an id they find to be published, so a waiting thread never blocks other threads from the shard.
+
+ All storage, including the shards and the segments, is obtained from the allocator. Storage for different shards is allocated at the same time from several threads, so unless the pool has a single shard, the allocator must be thread safe: for a pmr pool, use a resource such as std::pmr::synchronized_pool_resource rather than stdx::pmr::arena.
+
+ \tparam CharT character type.
+ \tparam Traits traits class specifying the operations on the character type
+ \tparam Allocator Allocator type used to allocate internal storage
+ */
+template <class CharT, class Traits = std::char_traits<CharT>, class Allocator = std::allocator<CharT>>
+class basic_concurrent_string_pool {
+  template <class T>
+  using rebind = typename std::allocator_traits<Allocator>::template rebind_alloc<T>;
+
+public:
+  /* Member types */
+  using view_type = std::basic_string_view<CharT, Traits>;
+  using size_type = std::size_t;
+  using id_type = std::uint32_t;
+  using allocator_type = Allocator;
+
+  /* Static constants */
+  /** Id returned by find for strings not in the pool. */
+  static constexpr id_type npos = static_cast<id_type>(-1);
+  /** Maximum number of shards. */
+  static constexpr unsigned max_shards = 64;
+
+  /* Constructors */
+  /** Construct an empty pool with \p shards shards, rounded up to a power of two. Defaults to four shards per hardware thread. If no allocator is supplied, allocator is obtained from a default-constructed instance. */
+  explicit basic_concurrent_string_pool(unsigned shards = 0, const Allocator& alloc = Allocator())
+  : alloc(alloc), next_id(0), published(0), segments{}, shard_table(nullptr) {
+    unsigned target = shards ? shards : 4 * std::max(1u, std::thread::hardware_concurrency());
+    shard_count = 1;
+    while (shard_count < target && shard_count < max_shards) { shard_count *= 2; }
+    rebind<shard> shard_alloc(alloc);
+    shard* table = std::allocator_traits<rebind<shard>>::allocate(shard_alloc, shard_count);
+    unsigned constructed = 0;
+    try {
+      for (; constructed < shard_count; ++constructed) { std::allocator_traits<rebind<shard>>::construct(shard_alloc, table + constructed, alloc); }
+    } catch (...) {
+      while (constructed > 0) { std::allocator_traits<rebind<shard>>::destroy(shard_alloc, table + --constructed); }
+      std::allocator_traits<rebind<shard>>::deallocate(shard_alloc, table, shard_count);
+      throw;
+    }
+    shard_table = table;
+  }
+  explicit basic_concurrent_string_pool(const Allocator& alloc) : basic_concurrent_string_pool(0, alloc) { }
+
+  basic_concurrent_string_pool(const basic_concurrent_string_pool&) = delete;
+  basic_concurrent_string_pool& operator=(const basic_concurrent_string_pool&) = delete;
+
+  /** Destructor */
+  ~basic_concurrent_string_pool() {
+    rebind<view_type> view_alloc(alloc);
+    for (unsigned segment = 0; segment < segment_count; ++segment) {
+      view_type* views = segments[segment].load(std::memory_order_relaxed);
+      if (views != nullptr) { std::allocator_traits<rebind<view_type>>::deallocate(view_alloc, views, segment_length(segment)); }
+    }
+    rebind<shard> shard_alloc(alloc);
+    for (unsigned i = 0; i < shard_count; ++i) { std::allocator_traits<rebind<shard>>::destroy(shard_alloc, shard_table + i); }
+    std::allocator_traits<rebind<shard>>::deallocate(shard_alloc, shard_table, shard_count);
+  }
+
+  /** Returns the allocator associated with the pool. */
+  allocator_type get_allocator() const noexcept { return alloc; }
+
+  /** Add \p str to the pool if it is not already there, and return its id. If the pool already holds npos strings, an exception of type std::length_error is thrown. */
+  id_type intern(view_type str) {
+    const std::size_t hash = detail::hash_code_units(str);
+    shard& s = shard_for(hash);
+    id_type id;
+    {
+      std::shared_lock<std::shared_mutex> lock(s.mutex);
+      id = s.find(str, hash, *this);
+    }
+    if (id != npos) { return wait_published(id); }
+    {
+      std::unique_lock<std::shared_mutex> lock(s.mutex);
+      id = s.find(str, hash, *this);
+      if (id != npos) {
+        lock.unlock();
+        return wait_published(id);
+      }
+      // Everything which can throw comes before the id is taken, as threads finding later ids wait for it to be published
+      if ((s.count + 1) * 2 > s.slots.size()) { s.grow(); }
+      const view_type stored(s.store.store(str.data(), str.size()), str.size());
+      id = reserve_id();
+      view_of(id) = stored;
+      s.insert(id, hash);
+    }
+    publish(id);
+    return id;
+  }
+  /** Returns the id of \p str, or npos if it is not in the pool. */
+  id_type find(view_type str) const {
+    const std::size_t hash = detail::hash_code_units(str);
+    shard& s = shard_for(hash);
+    id_type id;
+    {
+      std::shared_lock<std::shared_mutex> lock(s.mutex);
+      id = s.find(str, hash, *this);
+    }
+    return id == npos ? npos : wait_published(id);
+  }
+  /** Returns true if \p str is in the pool. */
+  bool contains(view_type str) const { return find(str) != npos; }
+
+  /** Returns a view of the string with id \p id. No bounds checking is performed. */
+  view_type operator[](id_type id) const noexcept { return view_of(id); }
+  /** Returns a view of the string with id \p id, with bounds checking. If \p id is not less than size(), an exception of type std::out_of_range is thrown. */
+  view_type at(id_type id) const {
+    if (id >= size()) { throw std::out_of_range("basic_concurrent_string_pool::at"); }
+    return (*this)[id];
+  }
+
+  /** Returns the number of strings published. Every id below it may be passed to at or operator[] by any thread. */
+  size_type size() const noexcept { return published.load(std::memory_order_acquire); }
+  /** Returns true if the pool is empty. */
+  bool empty() const noexcept { return size() == 0; }
+  /** Returns the number of shards. */
+  unsigned shards() const noexcept { return shard_count; }
+
+private:
+  static constexpr unsigned first_segment_bits = 10;
+  static constexpr unsigned segment_count = 33 - first_segment_bits;
+
+  struct alignas(detail::cache_line) shard {
+    struct entry {
+      std::size_t hash;
+      id_type id;
+    };
+
+    explicit shard(const Allocator& alloc) : slots(rebind<entry>(alloc)), store(alloc), count(0) { }
+
+    id_type find(view_type str, std::size_t hash, const basic_concurrent_string_pool& pool) const noexcept {
+      if (slots.empty()) { return npos; }
+      const std::size_t mask = slots.size() - 1;
+      for (std::size_t slot = hash & mask; slots[slot].id != npos; slot = (slot + 1) & mask) {
+        if (slots[slot].hash == hash && pool[slots[slot].id] == str) { return slots[slot].id; }
+      }
+      return npos;
+    }
+    void insert(id_type id, std::size_t hash) noexcept {
+      const std::size_t mask = slots.size() - 1;
+      std::size_t slot = hash & mask;
+      while (slots[slot].id != npos) { slot = (slot + 1) & mask; }
+      slots[slot] = entry{hash, id};
+      ++count;
+    }
+    void grow() {
+      std::vector<entry, rebind<entry>> old(slots.empty() ? 16 : slots.size() * 2, entry{0, npos}, slots.get_allocator());
+      old.swap(slots);
+      count = 0;
+      for (const entry& e : old) { if (e.id != npos) { insert(e.id, e.hash); } }
+    }
+
+    mutable std::shared_mutex mutex;
+    std::vector<entry, rebind<entry>> slots;
+    detail::chunk_store<CharT, Allocator> store;
+    std::size_t count;
+  };
+
+  shard& shard_for(std::size_t hash) const noexcept {
+    // Use the high bits of a remixed hash, so the shard is independent of the slot within the shard
+    const std::uint64_t mixed = static_cast<std::uint64_t>(hash) * detail::golden_multiplier;
+    return shard_table[static_cast<std::size_t>(mixed >> 58) & (shard_count - 1)];
+  }
+
+  /** Returns the segment and offset within it of \p id. Segment k holds 2^(k + first_segment_bits) views. */
+  static std::pair<unsigned, std::size_t> locate(id_type id) noexcept {
+    const std::uint64_t v = static_cast<std::uint64_t>(id) + (std::uint64_t(1) << first_segment_bits);
+    const unsigned top = 63u - static_cast<unsigned>(__builtin_clzll(v));
+    return {top - first_segment_bits, static_cast<std::size_t>(v - (std::uint64_t(1) << top))};
+  }
+  static std::size_t segment_length(unsigned segment) noexcept { return std::size_t(1) << (segment + first_segment_bits); }
+  /** Returns the view slot of \p id, whose segment must have been allocated. */
+  view_type& view_of(id_type id) const noexcept {
+    auto [segment, offset] = locate(id);
+    return segments[segment].load(std::memory_order_acquire)[offset];
+  }
+  /** Returns the segment holding \p id, allocating it if needed. */
+  view_type* ensure_segment(id_type id) {
+    const unsigned segment = locate(id).first;
+    view_type* views = segments[segment].load(std::memory_order_acquire);
+    if (views == nullptr) {
+      rebind<view_type> view_alloc(alloc);
+      view_type* created = std::allocator_traits<rebind<view_type>>::allocate(view_alloc, segment_length(segment));
+      std::uninitialized_value_construct_n(created, segment_length(segment));
+      if (segments[segment].compare_exchange_strong(views, created, std::memory_order_acq_rel)) {
+        views = created;
+      } else {
+        std::allocator_traits<rebind<view_type>>::deallocate(view_alloc, created, segment_length(segment));
+      }
+    }
+    return views;
+  }
+  /** Take the next id. Its segment is allocated first, so once an id is taken nothing can fail before it is published, and next_id never passes npos. */
+  id_type reserve_id() {
+    id_type id = next_id.load(std::memory_order_relaxed);
+    do {
+      if (id == npos) { throw std::length_error("basic_concurrent_string_pool::intern"); }
+      ensure_segment(id);
+    } while (!next_id.compare_exchange_weak(id, id + 1, std::memory_order_relaxed));
+    return id;
+  }
+  /** Wait for all lower ids to be published, then publish \p id, whose view has been stored. Called holding no lock, as the threads publishing lower ids may be waiting for it. */
+  void publish(id_type id) noexcept {
+    while (published.load(std::memory_order_acquire) != id) { std::this_thread::yield(); }
+    published.store(id + 1, std::memory_order_release);
+  }
+  /** Wait until \p id, found in a shard, has been published, and return it. The thread which added it has already left the shard, so it only waits for lower ids. */
+  id_type wait_published(id_type id) const noexcept {
+    while (published.load(std::memory_order_acquire) <= id) { std::this_thread::yield(); }
+    return id;
+  }
+
+  Allocator alloc;
+  std::atomic<id_type> next_id;   // Next id to reserve
+  std::atomic<id_type> published; // Ids below this have their views stored
+  std::atomic<view_type*> segments[segment_count];
+  shard* shard_table;
+  unsigned shard_count;
+};
+
+/** Typedefs for common character types **/
+using string_pool = basic_string_pool<char>;
+using wstring_pool = basic_string_pool<wchar_t>;
+using u16string_pool = basic_string_pool<char16_t>;
+using u32string_pool = basic_string_pool<char32_t>;
+
+using concurrent_string_pool = basic_concurrent_string_pool<char>;
+using wconcurrent_string_pool = basic_concurrent_string_pool<wchar_t>;
+using u16concurrent_string_pool = basic_concurrent_string_pool<char16_t>;
+using u32concurrent_string_pool = basic_concurrent_string_pool<char32_t>;
+
+namespace pmr {
+template <class CharT, class Traits = std::char_traits<CharT>>
+using basic_string_pool = stdx::basic_string_pool<CharT, Traits, std::pmr::polymorphic_allocator<CharT>>;
+
+using string_pool = basic_string_pool<char>;
+using wstring_pool = basic_string_pool<wchar_t>;
+using u16string_pool = basic_string_pool<char16_t>;
+using u32string_pool = basic_string_pool<char32_t>;
+
+template <class CharT, class Traits = std::char_traits<CharT>>
+using basic_concurrent_string_pool = stdx::basic_concurrent_string_pool<CharT, Traits, std::pmr::polymorphic_allocator<CharT>>;
+
+using concurrent_string_pool = basic_concurrent_string_pool<char>;
+using wconcurrent_string_pool = basic_concurrent_string_pool<wchar_t>;
+using u16concurrent_string_pool = basic_concurrent_string_pool<char16_t>;
+using u32concurrent_string_pool = basic_concurrent_string_pool<char32_t>;
+}
+
+}
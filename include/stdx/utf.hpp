@@ -0,0 +1,365 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include "char_class.hpp"
+
+namespace stdx {
+
+namespace detail {
+
+constexpr char32_t utf_invalid = static_cast<char32_t>(-1);
+
+/** Number of bits in the code units of the encoding used by CharT: UTF-8 for single byte types, UTF-16 for two byte types, and UTF-32 otherwise. */
+template <class CharT>
+constexpr unsigned utf_bits = sizeof(CharT) == 1 ? 8 : sizeof(CharT) == 2 ? 16 : 32;
+
+/** Returns the length of the valid UTF-8 sequence starting at \p s, given \p n bytes are available, or zero if it is invalid. Rejects overlong encodings, surrogates and code points above U+10FFFF. */
+inline std::size_t utf8_sequence_length(const unsigned char* s, std::size_t n) noexcept {
+  auto continuation = [](unsigned char c) { return (c & 0xc0) == 0x80; };
+  const unsigned char c = s[0];
+  if (c < 0x80) { return 1; }
+  if (c < 0xc2) { return 0; }
+  if (c < 0xe0) { return (n >= 2 && continuation(s[1])) ? 2 : 0; }
+  if (c < 0xf0) {
+    if (n < 3) { return 0; }
+    const unsigned char lo = c == 0xe0 ? 0xa0 : 0x80, hi = c == 0xed ? 0x9f : 0xbf;
+    return (s[1] >= lo && s[1] <= hi && continuation(s[2])) ? 3 : 0;
+  }
+  if (c < 0xf5) {
+    if (n < 4) { return 0; }
+    const unsigned char lo = c == 0xf0 ? 0x90 : 0x80, hi = c == 0xf4 ? 0x8f : 0xbf;
+    return (s[1] >= lo && s[1] <= hi && continuation(s[2]) && continuation(s[3])) ? 4 : 0;
+  }
+  return 0;
+}
+
+/* Length of the run of ASCII code units at the start of [s, s + n). Single byte types are scanned with SIMD kernels. */
+inline std::size_t ascii_run_scalar(const unsigned char* s, std::size_t n) noexcept {
+  std::size_t i = 0;
+  while (i < n && s[i] < 0x80) { ++i; }
+  return i;
+}
+#ifdef STDX_X86_SIMD
+inline std::size_t ascii_run_sse2(const unsigned char* s, std::size_t n) noexcept {
+  std::size_t i = 0;
+  for (; i + 16 <= n; i += 16) {
+    const unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i))));
+    if (mask) { return i + static_cast<std::size_t>(__builtin_ctz(mask)); }
+  }
+  return i + ascii_run_scalar(s + i, n - i);
+}
+__attribute__((target("avx2")))
+inline std::size_t ascii_run_avx2(const unsigned char* s, std::size_t n) noexcept {
+  std::size_t i = 0;
+  for (; i + 32 <= n; i += 32) {
+    const std::uint32_t mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + i))));
+    if (mask) { return i + static_cast<std::size_t>(__builtin_ctz(mask)); }
+  }
+  return i + ascii_run_scalar(s + i, n - i);
+}
+#endif
+template <class CharT>
+inline std::size_t ascii_run(const CharT* s, std::size_t n) noexcept {
+  if constexpr (sizeof(CharT) == 1) {
+    const unsigned char* u = reinterpret_cast<const unsigned char*>(s);
+    // Text which is mostly not ASCII would pay for the dispatch on every code point
+    if (n == 0 || u[0] >= 0x80) { return 0; }
+#ifdef STDX_X86_SIMD
+    if (n >= 32 && cpu_has_avx2()) { return ascii_run_avx2(u, n); }
+    if (n >= 16) { return ascii_run_sse2(u, n); }
+#endif
+    return ascii_run_scalar(u, n);
+  } else {
+    using unsigned_type = std::make_unsigned_t<CharT>;
+    std::size_t i = 0;
+    while (i < n && static_cast<unsigned_type>(s[i]) < 0x80) { ++i; }
+    return i;
+  }
+}
+
+/** Decode the code point starting at \p s[\p i], advancing \p i past it. Returns utf_invalid, without advancing, if the sequence is invalid. */
+template <class CharT>
+inline char32_t utf_decode(const CharT* s, std::size_t n, std::size_t& i) noexcept {
+  if constexpr (utf_bits<CharT> == 8) {
+    const unsigned char* u = reinterpret_cast<const unsigned char*>(s + i);
+    const std::size_t length = utf8_sequence_length(u, n - i);
+    char32_t cp;
+    switch (length) {
+      case 1: cp = u[0]; break;
+      case 2: cp = (char32_t(u[0] & 0x1f) << 6) | (u[1] & 0x3f); break;
+      case 3: cp = (char32_t(u[0] & 0x0f) << 12) | (char32_t(u[1] & 0x3f) << 6) | (u[2] & 0x3f); break;
+      case 4: cp = (char32_t(u[0] & 0x07) << 18) | (char32_t(u[1] & 0x3f) << 12) | (char32_t(u[2] & 0x3f) << 6) | (u[3] & 0x3f); break;
+      default: return utf_invalid;
+    }
+    i += length;
+    return cp;
+  } else if constexpr (utf_bits<CharT> == 16) {
+    const char32_t c = static_cast<std::uint16_t>(s[i]);
+    if (c < 0xd800 || c > 0xdfff) { ++i; return c; }
+    if (c > 0xdbff || i + 1 >= n) { return utf_invalid; }
+    const char32_t low = static_cast<std::uint16_t>(s[i + 1]);
+    if (low < 0xdc00 || low > 0xdfff) { return utf_invalid; }
+    i += 2;
+    return 0x10000 + ((c - 0xd800) << 10) + (low - 0xdc00);
+  } else {
+    const char32_t c = static_cast<char32_t>(s[i]);
+    if (c > 0x10ffff || (c >= 0xd800 && c <= 0xdfff)) { return utf_invalid; }
+    ++i;
+    return c;
+  }
+}
+
+/** Encode the valid code point \p cp to \p out, returning the number of code units written. */
+template <class CharT>
+inline std::size_t utf_encode(char32_t cp, CharT* out) noexcept {
+  if constexpr (utf_bits<CharT> == 8) {
+    if (cp < 0x80) { out[0] = static_cast<CharT>(cp); return 1; }
+    if (cp < 0x800) {
+      out[0] = static_cast<CharT>(0xc0 | (cp >> 6));
+      out[1] = static_cast<CharT>(0x80 | (cp & 0x3f));
+      return 2;
+    }
+    if (cp < 0x10000) {
+      out[0] = static_cast<CharT>(0xe0 | (cp >> 12));
+      out[1] = static_cast<CharT>(0x80 | ((cp >> 6) & 0x3f));
+      out[2] = static_cast<CharT>(0x80 | (cp & 0x3f));
+      return 3;
+    }
+    out[0] = static_cast<CharT>(0xf0 | (cp >> 18));
+    out[1] = static_cast<CharT>(0x80 | ((cp >> 12) & 0x3f));
+    out[2] = static_cast<CharT>(0x80 | ((cp >> 6) & 0x3f));
+    out[3] = static_cast<CharT>(0x80 | (cp & 0x3f));
+    return 4;
+  } else if constexpr (utf_bits<CharT> == 16) {
+    if (cp < 0x10000) { out[0] = static_cast<CharT>(cp); return 1; }
+    cp -= 0x10000;
+    out[0] = static_cast<CharT>(0xd800 + (cp >> 10));
+    out[1] = static_cast<CharT>(0xdc00 + (cp & 0x3ff));
+    return 2;
+  } else {
+    out[0] = static_cast<CharT>(cp);
+    return 1;
+  }
+}
+
+/** Maximum number of ToCharT code units produced from one FromCharT code unit. */
+template <class ToCharT, class FromCharT>
+constexpr std::size_t utf_expansion = utf_bits<ToCharT> == 8 ? (utf_bits<FromCharT> == 16 ? 3 : utf_bits<FromCharT> == 32 ? 4 : 1)
+                                    : (utf_bits<ToCharT> == 16 && utf_bits<FromCharT> == 32) ? 2 : 1;
+
+/** Transcode [\p in, \p in + \p n) to \p out, which must have room for n * utf_expansion code units. Returns the number of code units written. Runs of ASCII are copied directly. If the input is invalid, an exception of type std::range_error is thrown. */
+template <class ToCharT, class FromCharT>
+std::size_t utf_transcode(const FromCharT* in, std::size_t n, ToCharT* out) {
+  std::size_t i = 0, o = 0;
+  while (i < n) {
+    const std::size_t run = ascii_run(in + i, n - i);
+    for (std::size_t j = 0; j < run; ++j) { out[o + j] = static_cast<ToCharT>(in[i + j]); }
+    i += run;
+    o += run;
+    if (i == n) { break; }
+    const char32_t cp = utf_decode(in, n, i);
+    if (cp == utf_invalid) { throw std::range_error("Invalid UTF sequence."); }
+    o += utf_encode(cp, out + o);
+  }
+  return o;
+}
+
+/** Returns the length in bytes of the Unicode whitespace character starting at \p s, given \p n bytes are available, or zero if there is none. */
+inline std::size_t utf8_whitespace_at(const unsigned char* s, std::size_t n) noexcept {
+  const unsigned char c = s[0];
+  if (c < 0x80) { return (c == 0x20 || (c >= 0x09 && c <= 0x0d)) ? 1 : 0; }
+  if (c == 0xc2) { return (n >= 2 && (s[1] == 0x85 || s[1] == 0xa0)) ? 2 : 0; }  // U+0085, U+00A0
+  if (n < 3) { return 0; }
+  if (c == 0xe1) { return (s[1] == 0x9a && s[2] == 0x80) ? 3 : 0; }              // U+1680
+  if (c == 0xe2) {
+    if (s[1] == 0x80) { return ((s[2] >= 0x80 && s[2] <= 0x8a) || s[2] == 0xa8 || s[2] == 0xa9 || s[2] == 0xaf) ? 3 : 0; }  // U+2000-200A, U+2028, U+2029, U+202F
+    return (s[1] == 0x81 && s[2] == 0x9f) ? 3 : 0;                                // U+205F
+  }
+  if (c == 0xe3) { return (s[1] == 0x80 && s[2] == 0x80) ? 3 : 0; }              // U+3000
+  return 0;
+}
+/** Returns the length in bytes of the Unicode whitespace character ending at \p s[\p n - 1], or zero if there is none. */
+inline std::size_t utf8_whitespace_before(const unsigned char* s, std::size_t n) noexcept {
+  if (n == 0) { return 0; }
+  if (s[n - 1] < 0x80) { return utf8_whitespace_at(s + n - 1, 1); }
+  if (n >= 2 && utf8_whitespace_at(s + n - 2, 2) == 2) { return 2; }
+  if (n >= 3 && utf8_whitespace_at(s + n - 3, 3) == 3) { return 3; }
+  return 0;
+}
+
+/** Bytes which may start a Unicode whitespace character in UTF-8. */
+constexpr char utf8_whitespace_lead_chars[] = {0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x20, '\xc2', '\xe1', '\xe2', '\xe3'};
+constexpr char_class utf8_whitespace_leads{utf8_whitespace_lead_chars, std::size(utf8_whitespace_lead_chars)};
+
+}
+
+/** Tag selecting Unicode whitespace in UTF-8 text, for the strip and split operations of stdx::string. */
+struct utf8_whitespace_t {
+  explicit constexpr utf8_whitespace_t() = default;
+};
+inline constexpr utf8_whitespace_t utf8_whitespace{};
+
+/** Returns the position of the first byte of \p str which is not part of a valid UTF-8 sequence, or npos if \p str is valid UTF-8.
+ *  Overlong encodings, surrogates and code points above U+10FFFF are invalid. Runs of ASCII are skipped with SIMD kernels.
+ */
+inline std::size_t find_invalid_utf8(std::string_view str) noexcept {
+  const unsigned char* s = reinterpret_cast<const unsigned char*>(str.data());
+  const std::size_t n = str.size();
+  std::size_t i = 0;
+  while (i < n) {
+    i += detail::ascii_run(str.data() + i, n - i);
+    if (i == n) { break; }
+    const std::size_t length = detail::utf8_sequence_length(s + i, n - i);
+    if (length == 0) { return i; }
+    i += length;
+  }
+  return std::string_view::npos;
+}
+/** Returns true if \p str is valid UTF-8. */
+inline bool is_valid_utf8(std::string_view str) noexcept { return find_invalid_utf8(str) == std::string_view::npos; }
+
+/** Returns the number of code points in the valid UTF-8 text \p str. */
+inline std::size_t utf8_length(std::string_view str) noexcept {
+  const unsigned char* s = reinterpret_cast<const unsigned char*>(str.data());
+  const std::size_t n = str.size();
+  std::size_t count = 0, i = 0;
+#ifdef STDX_X86_SIMD
+  // Count the bytes which are not continuation bytes, 10xxxxxx, which are less than -64 as signed bytes
+  const __m128i limit = _mm_set1_epi8(-65);
+  for (; i + 16 <= n; i += 16) {
+    const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i));
+    count += static_cast<std::size_t>(__builtin_popcount(static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpgt_epi8(block, limit)))));
+  }
+#endif
+  for (; i < n; ++i) { count += (s[i] & 0xc0) != 0x80; }
+  return count;
+}
+
+/** Transcode \p in to \p out, appending to it.
+ *  The encoding of each side is chosen by its character type: UTF-8 for char, UTF-16 for char16_t, UTF-32 for char32_t, and UTF-16 or UTF-32 for wchar_t, depending on its size. Output is written in a single pass to storage allocated once, and runs of ASCII are copied directly. If \p in is not valid, an exception of type std::range_error is thrown and \p out is unchanged.
+ */
+template <class ToCharT, class ToTraits, class ToAllocator, class FromCharT, class FromTraits>
+void utf_transcode(std::basic_string_view<FromCharT, FromTraits> in, std::basic_string<ToCharT, ToTraits, ToAllocator>& out) {
+  const std::size_t start = out.size();
+  out.resize(start + in.size() * detail::utf_expansion<ToCharT, FromCharT>);
+  try {
+    out.resize(start + detail::utf_transcode(in.data(), in.size(), &out[0] + start));
+  } catch (...) {
+    out.resize(start);
+    throw;
+  }
+}
+
+/** Convert between UTF-8, UTF-16 and UTF-32. See utf_transcode. */
+inline std::u16string utf8_to_utf16(std::string_view str) { std::u16string out; utf_transcode(str, out); return out; }
+inline std::u32string utf8_to_utf32(std::string_view str) { std::u32string out; utf_transcode(str, out); return out; }
+inline std::string utf16_to_utf8(std::u16string_view str) { std::string out; utf_transcode(str, out); return out; }
+inline std::u32string utf16_to_utf32(std::u16string_view str) { std::u32string out; utf_transcode(str, out); return out; }
+inline std::string utf32_to_utf8(std::u32string_view str) { std::string out; utf_transcode(str, out); return out; }
+inline std::u16string utf32_to_utf16(std::u32string_view str) { std::u16string out; utf_transcode(str, out); return out; }
+
+/** Strip leading Unicode whitespace from the UTF-8 text \p str, returning a view of the remainder. */
+inline std::string_view utf8_lstrip(std::string_view str) noexcept {
+  const unsigned char* s = reinterpret_cast<const unsigned char*>(str.data());
+  std::size_t i = 0;
+  while (i < str.size()) {
+    const std::size_t length = detail::utf8_whitespace_at(s + i, str.size() - i);
+    if (length == 0) { break; }
+    i += length;
+  }
+  return str.substr(i);
+}
+/** Strip trailing Unicode whitespace from the UTF-8 text \p str, returning a view of the remainder. */
+inline std::string_view utf8_rstrip(std::string_view str) noexcept {
+  const unsigned char* s = reinterpret_cast<const unsigned char*>(str.data());
+  std::size_t n = str.size();
+  while (std::size_t length = detail::utf8_whitespace_before(s, n)) { n -= length; }
+  return str.substr(0, n);
+}
+/** Strip leading and trailing Unicode whitespace from the UTF-8 text \p str, returning a view of the remainder. */
+inline std::string_view utf8_strip(std::string_view str) noexcept { return utf8_rstrip(utf8_lstrip(str)); }
+
+/** Lazy range of the tokens of UTF-8 text separated by runs of Unicode whitespace.
+
+ As basic_split_view in whitespace mode, but recognising all characters with the Unicode White_Space property, decoded as the text is iterated. Candidate separators are found with a SIMD search for the bytes which can start a whitespace character. The referenced text must outlive the view.
+ */
+class utf8_split_view {
+public:
+  /* Member types */
+  using view_type = std::string_view;
+  using size_type = std::size_t;
+
+  /** Forward iterator over the tokens of a utf8_split_view. */
+  class iterator {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = view_type;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const view_type*;
+    using reference = const view_type&;
+
+    /** Constructs an end iterator. */
+    iterator() noexcept : rest(), token(), at_end(true) { }
+
+    reference operator*() const noexcept { return token; }
+    pointer operator->() const noexcept { return &token; }
+
+    iterator& operator++() noexcept { advance(); return *this; }
+    iterator operator++(int) noexcept { iterator tmp(*this); advance(); return tmp; }
+
+    friend bool operator==(const iterator& lhs, const iterator& rhs) noexcept {
+      if (lhs.at_end || rhs.at_end) { return lhs.at_end == rhs.at_end; }
+      return lhs.token.data() == rhs.token.data() && lhs.token.size() == rhs.token.size();
+    }
+    friend bool operator!=(const iterator& lhs, const iterator& rhs) noexcept { return !(lhs == rhs); }
+
+  private:
+    friend class utf8_split_view;
+
+    explicit iterator(view_type str) noexcept : rest(str), token(), at_end(false) { advance(); }
+
+    void advance() noexcept {
+      rest = utf8_lstrip(rest);
+      if (rest.empty()) { at_end = true; return; }
+      const unsigned char* s = reinterpret_cast<const unsigned char*>(rest.data());
+      size_type pos = 0;
+      for (;;) {
+        pos = detail::utf8_whitespace_leads.find_first_of(rest.data(), rest.size(), pos);
+        if (pos == view_type::npos || detail::utf8_whitespace_at(s + pos, rest.size() - pos) != 0) { break; }
+        ++pos;
+      }
+      token = rest.substr(0, pos);
+      rest = (pos == view_type::npos) ? view_type() : rest.substr(pos);
+    }
+
+    view_type rest;
+    view_type token;
+    bool at_end;
+  };
+  using const_iterator = iterator;
+
+  /* Constructors */
+  /** Construct a view splitting the UTF-8 text \p str at Unicode whitespace. */
+  explicit utf8_split_view(view_type str) noexcept : str(str) { }
+
+  /** Returns an iterator to the first token. */
+  iterator begin() const noexcept { return iterator(str); }
+  /** Returns the end iterator. */
+  iterator end() const noexcept { return iterator(); }
+  /** Returns true if the range contains no tokens. */
+  bool empty() const noexcept { return begin() == end(); }
+  /** Returns the text being split. */
+  view_type base() const noexcept { return str; }
+
+private:
+  view_type str;
+};
+
+}
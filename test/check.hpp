@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstdio>
+
+/* Minimal checking for the tests. A failed CHECK reports its location and expression, and makes the test return a failure status from check_result. */
+namespace stdx_test {
+inline int failures = 0;
+inline int check_result() {
+  if (failures) { std::fprintf(stderr, "%d check(s) failed\n", failures); }
+  return failures == 0 ? 0 : 1;
+}
+}
+
+#define CHECK(cond) \
+  do { \
+    if (!(cond)) { \
+      std::fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #cond); \
+      ++stdx_test::failures; \
+    } \
+  } while (0)
@@ -0,0 +1,125 @@
+//
+//  test_ascii.cpp
+//  test
+//
+//  ASCII case conversion kernels against std::tolower and std::toupper in the C locale.
+//
+
+#include <cctype>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <stdx/ascii.hpp>
+#include <stdx/string.hpp>
+
+#include "check.hpp"
+
+namespace {
+
+using stdx::detail::ascii_case;
+
+unsigned char reference(ascii_case c, unsigned char u) {
+  // The C locale is in effect, as the program never calls setlocale
+  if (c == ascii_case::lower) { return static_cast<unsigned char>(std::tolower(u)); }
+  if (c == ascii_case::upper) { return static_cast<unsigned char>(std::toupper(u)); }
+  return static_cast<unsigned char>(std::islower(u) ? std::toupper(u) : std::tolower(u));
+}
+
+/* Every byte value at every position, for lengths covering each tail length of the 16 and 32 byte kernels. */
+template <ascii_case Case>
+void test_convert() {
+  for (std::size_t n = 0; n <= 96; ++n) {
+    for (unsigned offset = 0; offset < 256; offset += (n > 40 ? 37 : 1)) {
+      std::vector<unsigned char> src(n), expected(n), out(n);
+      for (std::size_t i = 0; i < n; ++i) {
+        src[i] = static_cast<unsigned char>(offset + i * 7);
+        expected[i] = reference(Case, src[i]);
+      }
+      stdx::detail::ascii_convert_scalar<Case>(out.data(), src.data(), n);
+      CHECK(out == expected);
+#ifdef STDX_X86_SIMD
+      out.assign(n, 0);
+      stdx::detail::ascii_convert_sse2<Case>(out.data(), src.data(), n);
+      CHECK(out == expected);
+      if (stdx::detail::cpu_has_avx2()) {
+        out.assign(n, 0);
+        stdx::detail::ascii_convert_avx2<Case>(out.data(), src.data(), n);
+        CHECK(out == expected);
+      }
+#endif
+      out.assign(n, 0);
+      stdx::detail::ascii_convert<Case>(out.data(), src.data(), n);
+      CHECK(out == expected);
+      // Inplace
+      out = src;
+      stdx::detail::ascii_convert<Case>(out.data(), out.data(), n);
+      CHECK(out == expected);
+    }
+  }
+}
+
+void test_iequal() {
+  for (std::size_t n = 0; n <= 70; ++n) {
+    std::string a(n, ' '), b(n, ' ');
+    for (std::size_t i = 0; i < n; ++i) {
+      a[i] = static_cast<char>('a' + i % 26);
+      b[i] = static_cast<char>(i % 2 ? 'A' + i % 26 : 'a' + i % 26);
+    }
+    CHECK(stdx::iequals(std::string_view(a), std::string_view(b)));
+    CHECK(stdx::basic_ihash<char>()(a) == stdx::basic_ihash<char>()(b));
+    for (std::size_t pos = 0; pos < n; ++pos) {
+      // '@' and '`' are one below 'A' and 'a', and '[' and '{' one above 'Z' and 'z', so differ from letters only in case bits
+      for (char c : {'@', '`', '[', '{', '\xc1', '\xe1'}) {
+        std::string d = b;
+        d[pos] = c;
+        const auto* x = reinterpret_cast<const unsigned char*>(a.data());
+        const auto* y = reinterpret_cast<const unsigned char*>(d.data());
+        CHECK(!stdx::detail::ascii_iequal_scalar(x, y, n));
+#ifdef STDX_X86_SIMD
+        CHECK(!stdx::detail::ascii_iequal_sse2(x, y, n));
+        if (stdx::detail::cpu_has_avx2()) { CHECK(!stdx::detail::ascii_iequal_avx2(x, y, n)); }
+#endif
+        CHECK(!stdx::iequals(std::string_view(a), std::string_view(d)));
+      }
+    }
+  }
+}
+
+void test_swar() {
+  for (unsigned base = 0; base < 256; base += 8) {
+    unsigned char bytes[8];
+    for (unsigned i = 0; i < 8; ++i) { bytes[i] = static_cast<unsigned char>(base + i); }
+    std::uint64_t w;
+    std::memcpy(&w, bytes, 8);
+    w = stdx::detail::swar_ascii_lower(w);
+    std::memcpy(bytes, &w, 8);
+    for (unsigned i = 0; i < 8; ++i) { CHECK(bytes[i] == reference(ascii_case::lower, static_cast<unsigned char>(base + i))); }
+  }
+}
+
+void test_members() {
+  const stdx::string s = "Hello, WORLD! \xc3\x89t\xc3\xa9 0123456789 abcdefghijklmnopqrstuvwxyz";
+  std::string lower = s, upper = s;
+  for (char& c : lower) { c = static_cast<char>(std::tolower(static_cast<unsigned char>(c))); }
+  for (char& c : upper) { c = static_cast<char>(std::toupper(static_cast<unsigned char>(c))); }
+  CHECK(s.lower() == lower);
+  CHECK(s.upper() == upper);
+  CHECK(s.swapcase().swapcase() == s);
+  CHECK(s.casefold() == lower);
+  stdx::u16string w = u"MiXeD É";
+  CHECK(w.lower() == u"mixed É");
+}
+
+}
+
+int main() {
+  test_convert<ascii_case::lower>();
+  test_convert<ascii_case::upper>();
+  test_convert<ascii_case::swap>();
+  test_iequal();
+  test_swar();
+  test_members();
+  return stdx_test::check_result();
+}
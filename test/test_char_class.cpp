@@ -0,0 +1,131 @@
+//
+//  test_char_class.cpp
+//  test
+//
+//  SIMD kernels of basic_char_class against the scalar kernels and a naive search.
+//
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <stdx/char_class.hpp>
+
+#include "check.hpp"
+
+namespace {
+
+using stdx::detail::byte_set;
+using stdx::detail::scan_npos;
+
+const std::size_t lengths[] = {0, 1, 15, 16, 17, 31, 32, 33, 47, 48, 63, 64, 65, 100};
+
+byte_set make_set(const std::string& members) {
+  byte_set set{};
+  for (char c : members) { set.insert(static_cast<std::uint8_t>(c)); }
+  return set;
+}
+
+/* Compare every kernel that applies to \p set on \p s, for member and non-member searches in both directions. */
+void check_kernels(const std::string& s, const byte_set& set) {
+  const unsigned char* p = reinterpret_cast<const unsigned char*>(s.data());
+  const std::size_t n = s.size();
+  const std::size_t first_member = stdx::detail::find_first_scalar<true>(p, n, set);
+  const std::size_t first_other = stdx::detail::find_first_scalar<false>(p, n, set);
+  const std::size_t last_member = stdx::detail::find_last_scalar<true>(p, n, set);
+  const std::size_t last_other = stdx::detail::find_last_scalar<false>(p, n, set);
+#ifdef STDX_X86_SIMD
+  if (set.small_count <= byte_set::max_small) {
+    CHECK(stdx::detail::find_first_sse2<true>(p, n, set) == first_member);
+    CHECK(stdx::detail::find_first_sse2<false>(p, n, set) == first_other);
+    CHECK(stdx::detail::find_last_sse2<true>(p, n, set) == last_member);
+    CHECK(stdx::detail::find_last_sse2<false>(p, n, set) == last_other);
+  }
+  if (stdx::detail::cpu_has_avx2()) {
+    CHECK(stdx::detail::find_first_avx2<true>(p, n, set) == first_member);
+    CHECK(stdx::detail::find_first_avx2<false>(p, n, set) == first_other);
+    CHECK(stdx::detail::find_last_avx2<true>(p, n, set) == last_member);
+    CHECK(stdx::detail::find_last_avx2<false>(p, n, set) == last_other);
+  }
+#endif
+  CHECK(stdx::detail::find_first<true>(p, n, set) == first_member);
+  CHECK(stdx::detail::find_first<false>(p, n, set) == first_other);
+  CHECK(stdx::detail::find_last<true>(p, n, set) == last_member);
+  CHECK(stdx::detail::find_last<false>(p, n, set) == last_other);
+}
+
+/* The scalar kernels against a naive search. */
+void check_scalar(const std::string& s, const std::string& members) {
+  const byte_set set = make_set(members);
+  const unsigned char* p = reinterpret_cast<const unsigned char*>(s.data());
+  const std::size_t expected_first = s.find_first_of(members), expected_last = s.find_last_of(members);
+  CHECK(stdx::detail::find_first_scalar<true>(p, s.size(), set) == (expected_first == std::string::npos ? scan_npos : expected_first));
+  CHECK(stdx::detail::find_last_scalar<true>(p, s.size(), set) == (expected_last == std::string::npos ? scan_npos : expected_last));
+}
+
+void test_set(const std::string& members, const std::string& others) {
+  const byte_set set = make_set(members);
+  std::mt19937 rng(7);
+  for (std::size_t n : lengths) {
+    // No members, all members, a single member at each position, and a single non-member at each position
+    check_kernels(std::string(n, others[0]), set);
+    check_kernels(std::string(n, members[0]), set);
+    for (std::size_t pos = 0; pos < n; ++pos) {
+      for (char m : members) {
+        std::string s(n, others[pos % others.size()]);
+        s[pos] = m;
+        check_kernels(s, set);
+        check_scalar(s, members);
+      }
+      std::string s(n, members[pos % members.size()]);
+      s[pos] = others[0];
+      check_kernels(s, set);
+    }
+    // Random mixtures
+    for (int trial = 0; trial < 50; ++trial) {
+      std::string s(n, ' ');
+      for (char& c : s) { c = (rng() % 4 == 0) ? members[rng() % members.size()] : others[rng() % others.size()]; }
+      check_kernels(s, set);
+      check_scalar(s, members);
+    }
+  }
+}
+
+void test_public_api() {
+  const stdx::char_class comma(",;");
+  for (std::size_t n : lengths) {
+    std::string s(n, 'x');
+    CHECK(comma.find_first_of(s.data(), n) == stdx::char_class::npos);
+    CHECK(stdx::char_classes<char>::whitespace.find_first_not_of(s.data(), n) == (n ? 0 : stdx::char_class::npos));
+    for (std::size_t pos = 0; pos < n; ++pos) {
+      std::string t = s;
+      t[pos] = ';';
+      CHECK(comma.find_first_of(t.data(), n) == pos);
+      CHECK(comma.find_last_of(t.data(), n) == pos);
+      CHECK(comma.find_first_of(t.data(), n, pos) == pos);
+      CHECK(comma.find_first_of(t.data(), n, pos + 1) == stdx::char_class::npos);
+      CHECK(comma.find_last_of(t.data(), n, pos) == pos);
+      CHECK(pos == 0 || comma.find_last_of(t.data(), n, pos - 1) == stdx::char_class::npos);
+    }
+  }
+  // Wide characters beyond the bitmap
+  stdx::u16char_class wide(u" ,");
+  const std::u16string w = u"ab c,";
+  CHECK(wide.find_first_of(w.data(), w.size()) == 2);
+  CHECK(wide.find_last_of(w.data(), w.size()) == 4);
+  CHECK(wide.find_first_not_of(w.data(), w.size(), 2) == 3);
+}
+
+}
+
+int main() {
+  // Sets of at most max_small members use the SSE2 kernel, larger ones only AVX2. Include bytes above 0x7f, which use the high nibble table.
+  test_set(" \t,", "abcXYZ019");
+  test_set(std::string("\x80\xff\x7f\x00", 4), "abc");
+  test_set("abcdefgh", "ijk ,.\xc3");
+  test_set("abcdefghi", "jkl ,.\xc3");
+  test_set("0123456789ABCDEFabcdef\x90\xe0", "ghz ,.\x7f\xf0");
+  test_public_api();
+  return stdx_test::check_result();
+}
@@ -0,0 +1,99 @@
+//
+//  test_concurrent_fixed_histogram.cpp
+//  test
+//
+//  Totals of concurrent_fixed_histogram after many threads add at once, merge range checks, bounds checked add_at, and reset.
+//
+
+#include <cstdint>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <stdx/concurrent_fixed_histogram.hpp>
+
+#include "check.hpp"
+
+namespace {
+
+template <class F>
+bool throws_range_error(F f) {
+  try { f(); } catch (const std::range_error&) { return true; }
+  return false;
+}
+
+// Every add is counted once, whether the threads share a shard or not
+void test_threads() {
+  constexpr int threads = 8, adds = 20000;
+  for (unsigned shards : {1u, 3u, 0u}) {
+    stdx::concurrent_fixed_histogram<> h(-5, 5, shards);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+      workers.emplace_back([&h, t] {
+        for (int i = 0; i < adds; ++i) { h.add((t * adds + i) % 11 - 5); }
+      });
+    }
+    for (std::thread& w : workers) { w.join(); }
+
+    const stdx::fixed_vector<int64_t> totals = h.snapshot();
+    CHECK(totals.min_index() == -5 && totals.max_index() == 5);
+    int64_t sum = 0;
+    for (int64_t count : totals) { sum += count; }
+    CHECK(sum == int64_t(threads) * adds);
+    for (int64_t i = -5; i <= 5; ++i) { CHECK(h[i] == totals[i]); }
+    CHECK(totals[-5] == (int64_t(threads) * adds + 10) / 11);
+  }
+}
+
+void test_merge() {
+  stdx::concurrent_fixed_histogram<int32_t> h(0, 3, 2);
+  h.add(1, 5);
+  h.add(3);
+  stdx::fixed_vector<int32_t> out(0, 3, 1);
+  h.merge(out);
+  CHECK(out[0] == 1 && out[1] == 6 && out[2] == 1 && out[3] == 2);
+
+  stdx::fixed_vector<int32_t> shifted(1, 4, 0), shorter(0, 2, 0), wider(-1, 3, 0);
+  CHECK(throws_range_error([&] { h.merge(shifted); }));
+  CHECK(throws_range_error([&] { h.merge(shorter); }));
+  CHECK(throws_range_error([&] { h.merge(wider); }));
+  CHECK(shifted[1] == 0 && shorter[0] == 0 && wider[3] == 0);
+}
+
+void test_add_at() {
+  stdx::concurrent_fixed_histogram<> h(-2, 2, 1);
+  h.add_at(-2, 3);
+  h.add_at(2);
+  CHECK(h[-2] == 3 && h[2] == 1);
+  bool threw = false;
+  try { h.add_at(3); } catch (const std::out_of_range&) { threw = true; }
+  CHECK(threw);
+  threw = false;
+  try { h.add_at(-3, 10); } catch (const std::out_of_range&) { threw = true; }
+  CHECK(threw);
+  CHECK(h[-2] == 3 && h[2] == 1);
+}
+
+void test_reset() {
+  // More bins than fit in one cache line, so every line of every shard is cleared
+  stdx::concurrent_fixed_histogram<int8_t> h(0, 199, 4);
+  for (int64_t i = 0; i <= 199; ++i) { h.add(i, 2); }
+  CHECK(h[0] == 2 && h[199] == 2);
+  h.reset();
+  const stdx::fixed_vector<int8_t> totals = h.snapshot();
+  bool zero = true;
+  for (int8_t count : totals) { zero = zero && count == 0; }
+  CHECK(zero);
+  h.add(100);
+  CHECK(h[100] == 1);
+}
+
+}
+
+int main() {
+  test_threads();
+  test_merge();
+  test_add_at();
+  test_reset();
+  return stdx_test::check_result();
+}
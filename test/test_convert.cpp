@@ -0,0 +1,97 @@
+//
+//  test_convert.cpp
+//  test
+//
+//  Leading numeric conversion with basic_string::convert, and whole string conversion with stdx::convert.
+//
+
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include <stdx/fixed_vector.hpp>
+
+#include <stdx/string.hpp>
+
+#include "check.hpp"
+
+namespace {
+
+template <class T>
+T leading(const char* str) { return stdx::string(str).convert<T>(); }
+
+void test_signs_and_whitespace() {
+  CHECK(leading<int>("  +42abc") == 42);
+  CHECK(leading<int>("\t-7 ") == -7);
+  CHECK(leading<int>("+-5") == 0);
+  CHECK(leading<int>("-+5") == 0);
+  CHECK(leading<int>("+") == 0);
+  CHECK(leading<int>("+ 5") == 0);
+  CHECK(leading<int>("") == 0 && leading<int>("   ") == 0);
+  CHECK(leading<double>("+.5") == 0.5);
+  CHECK(leading<double>("+-5") == 0);
+  CHECK(leading<std::uint32_t>("-1") == 0);
+}
+
+void test_hex_floats() {
+  CHECK(leading<double>("0x10") == 16);
+  CHECK(leading<double>("0X1.8p1") == 3);
+  CHECK(leading<double>("-0x1.8p1") == -3);
+  CHECK(leading<float>(" +0x1p-2") == 0.25f);
+  CHECK(leading<double>("0x") == 0 && leading<double>("0xg") == 0 && leading<double>("0x-5") == 0);
+  // Integers are decimal, as with std::strtol in base 10
+  CHECK(leading<int>("0x10") == 0);
+}
+
+void test_saturation() {
+  CHECK(leading<std::int32_t>("4000000000") == std::numeric_limits<std::int32_t>::max());
+  CHECK(leading<std::int32_t>("-4000000000") == std::numeric_limits<std::int32_t>::min());
+  CHECK(leading<std::uint8_t>("300") == 255);
+  CHECK(leading<std::int64_t>("99999999999999999999") == std::numeric_limits<std::int64_t>::max());
+  const double inf = std::numeric_limits<double>::infinity();
+  CHECK(leading<double>("1e400") == inf && leading<double>("-1e400") == -inf);
+  CHECK(leading<double>("123456e99999999999999999999") == inf);
+  CHECK(leading<double>("1e-400") == 0 && leading<double>("0.0001e-330") == 0);
+  CHECK(leading<double>("0x1p99999") == inf && leading<double>("-0x0.001p-99999") == 0);
+  CHECK(leading<float>("1e39") == std::numeric_limits<float>::infinity());
+}
+
+void test_whole() {
+  CHECK(stdx::convert<int>("42").value == 42);
+  CHECK(!stdx::convert<int>("42x"));
+  CHECK(!stdx::convert<int>(" 42"));
+  CHECK(!stdx::convert<std::int8_t>("300"));
+}
+
+void test_columns() {
+  const std::vector<std::string> tokens = {"1", "-2", "x", "4"};
+  std::vector<int> appended = {9};
+  auto partial = stdx::convert_column(tokens.begin(), tokens.end(), appended);
+  CHECK(partial.count == 2 && partial.ec == std::errc::invalid_argument && partial.in == tokens.begin() + 2);
+  CHECK((appended == std::vector<int>{9, 1, -2}));
+
+  stdx::fixed_vector<int> column(0, 2, 5);
+  auto converted = stdx::convert_column(tokens.begin(), tokens.begin() + 2, column, -1);
+  CHECK(converted && converted.count == 2 && column.min_index() == -1 && column.max_index() == 0 && column[-1] == 1 && column[0] == -2);
+  converted = stdx::convert_column(tokens.begin(), tokens.end(), column, 10);
+  CHECK(!converted && column.size() == 4 && column[11] == -2 && column[12] == 0 && column[13] == 0);
+
+  // An empty range is valid input for both kinds of column
+  const std::vector<std::string> none;
+  auto empty = stdx::convert_column(none.begin(), none.end(), column, 3);
+  CHECK(empty && empty.count == 0 && empty.in == none.end() && column.size() == 0);
+  std::vector<double> values;
+  CHECK(stdx::convert_column(none.begin(), none.end(), values) && values.empty());
+}
+
+}
+
+int main() {
+  test_signs_and_whitespace();
+  test_hex_floats();
+  test_saturation();
+  test_whole();
+  test_columns();
+  return stdx_test::check_result();
+}
@@ -0,0 +1,116 @@
+//
+//  test_fixed_soa_vector.cpp
+//  test
+//
+//  Records of fixed_soa_vector: access through operator[] and field views, offset preserving resize, rollback of a throwing resize, and cache line aligned columns.
+//
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+
+#include <stdx/fixed_soa_vector.hpp>
+
+#include "check.hpp"
+
+namespace {
+
+// Field whose default constructor throws once a budget of constructions is spent
+struct fragile {
+  static inline int budget = -1;
+  int value = 0;
+  fragile() {
+    if (budget == 0) { throw std::runtime_error("fragile"); }
+    if (budget > 0) { --budget; }
+  }
+  explicit fragile(int v) : value(v) { }
+};
+
+template <class... Fields>
+bool aligned(const stdx::fixed_soa_vector<Fields...>& soa) {
+  return reinterpret_cast<std::uintptr_t>(soa.template data<0>()) % stdx::detail::cache_line == 0 &&
+         reinterpret_cast<std::uintptr_t>(soa.template data<1>()) % stdx::detail::cache_line == 0;
+}
+
+void test_records() {
+  stdx::fixed_soa_vector<int, std::string> soa(-2, 2);
+  CHECK(soa.size() == 5 && soa.min_index() == -2 && soa.max_index() == 2);
+  for (int64_t i = -2; i <= 2; ++i) {
+    std::get<0>(soa[i]) = static_cast<int>(i) * 10;
+    std::get<1>(soa[i]) = std::to_string(i);
+  }
+  soa[0] = std::make_tuple(7, std::string("seven"));
+  CHECK(soa.data<0>()[2] == 7 && soa.data<1>()[2] == "seven");
+
+  auto [number, name] = soa[-2];
+  CHECK(number == -20 && name == "-2");
+  number = 1;
+  CHECK(std::get<0>(soa[-2]) == 1);
+
+  auto numbers = soa.field<0>();
+  auto names = soa.field<1>();
+  CHECK(numbers[-1] == -10 && numbers[0] == 7 && numbers[2] == 20);
+  CHECK(names[1] == "1" && names[2] == "2");
+  names[2] = "two";
+  CHECK(std::get<1>(soa.at(2)) == "two");
+
+  const auto& csoa = soa;
+  CHECK(std::get<0>(csoa[1]) == 10 && csoa.field<0>()[1] == 10);
+  bool threw = false;
+  try { soa.at(3); } catch (const std::out_of_range&) { threw = true; }
+  CHECK(threw);
+  threw = false;
+  try { csoa.at(-3); } catch (const std::out_of_range&) { threw = true; }
+  CHECK(threw);
+}
+
+// Records keep their offset from the minimum index, as in fixed_vector
+void test_resize() {
+  stdx::fixed_soa_vector<int, double> soa(0, 3, std::make_tuple(0, 0.0));
+  for (int64_t i = 0; i <= 3; ++i) { soa[i] = std::make_tuple(static_cast<int>(i), i * 0.5); }
+  soa.resize(10, 15, std::make_tuple(-1, -1.0));
+  CHECK(soa.size() == 6 && soa.min_index() == 10 && soa.max_index() == 15);
+  CHECK(std::get<0>(soa[10]) == 0 && std::get<0>(soa[13]) == 3 && std::get<1>(soa[13]) == 1.5);
+  CHECK(std::get<0>(soa[14]) == -1 && std::get<1>(soa[15]) == -1.0);
+  soa.resize(-1, 0);
+  CHECK(soa.size() == 2 && std::get<0>(soa[-1]) == 0 && std::get<0>(soa[0]) == 1);
+  soa.resize(-1, 1);
+  CHECK(std::get<0>(soa[1]) == 0 && std::get<1>(soa[1]) == 0.0);
+}
+
+// A record whose construction throws leaves the size, bounds and values of every column as they were
+void test_resize_rollback() {
+  stdx::fixed_soa_vector<int, fragile> soa(1, 3);
+  for (int64_t i = 1; i <= 3; ++i) { soa[i] = std::make_tuple(static_cast<int>(i), fragile(static_cast<int>(i) * 100)); }
+  fragile::budget = 2;
+  bool threw = false;
+  try { soa.resize(1, 10); } catch (const std::runtime_error&) { threw = true; }
+  fragile::budget = -1;
+  CHECK(threw);
+  CHECK(soa.size() == 3 && soa.min_index() == 1 && soa.max_index() == 3);
+  CHECK(std::get<0>(soa[1]) == 1 && std::get<0>(soa[3]) == 3);
+  CHECK(std::get<1>(soa[1]).value == 100 && std::get<1>(soa[3]).value == 300);
+  CHECK(aligned(soa));
+  soa.resize(1, 5);
+  CHECK(soa.size() == 5 && std::get<1>(soa[3]).value == 300 && std::get<1>(soa[5]).value == 0);
+}
+
+void test_alignment() {
+  stdx::fixed_soa_vector<char, double> soa(0, 2);
+  CHECK(aligned(soa));
+  soa.resize(0, 1000);
+  CHECK(aligned(soa));
+  soa.assign(-5, 5, std::make_tuple('x', 1.0));
+  CHECK(aligned(soa) && std::get<0>(soa[-5]) == 'x');
+}
+
+}
+
+int main() {
+  test_records();
+  test_resize();
+  test_resize_rollback();
+  test_alignment();
+  return stdx_test::check_result();
+}
@@ -0,0 +1,85 @@
+//
+//  test_fixed_vector.cpp
+//  test
+//
+//  Index bounds rules shared by the constructors, assign, resize and slide, and sliding windows of fixed_vector and ring_fixed_vector.
+//
+
+#include <stdexcept>
+#include <string>
+
+#include <stdx/concurrent_fixed_histogram.hpp>
+#include <stdx/fixed_soa_vector.hpp>
+#include <stdx/fixed_vector.hpp>
+#include <stdx/ring_fixed_vector.hpp>
+
+#include "check.hpp"
+
+namespace {
+
+template <class F>
+bool throws_range_error(F f) {
+  try { f(); } catch (const std::range_error&) { return true; }
+  return false;
+}
+
+// Every operation taking bounds accepts max == min, a single element, and rejects max < min
+void test_bounds() {
+  stdx::fixed_vector<int> single(4, 4, 7);
+  CHECK(single.size() == 1 && single[4] == 7);
+  CHECK(stdx::fixed_vector<int>(-2, -2).size() == 1);
+  CHECK(throws_range_error([] { stdx::fixed_vector<int>(5, 4); }));
+  CHECK(throws_range_error([] { stdx::fixed_vector<int>(5, 4, 0); }));
+
+  stdx::fixed_vector<int> v(0, 9, 1);
+  v.assign(3, 3, 2);
+  CHECK(v.size() == 1 && v[3] == 2);
+  CHECK(throws_range_error([&] { v.assign(3, 2, 0); }));
+  v.resize(3, 3);
+  CHECK(v.size() == 1);
+  CHECK(throws_range_error([&] { v.resize(3, 2); }));
+  CHECK(throws_range_error([&] { v.resize(3, 2, 0); }));
+  CHECK(v.min_index() == 3 && v.max_index() == 3);
+  v.slide(8, 8, 5);
+  CHECK(v.size() == 1 && v[8] == 5);
+  CHECK(throws_range_error([&] { v.slide(8, 7); }));
+
+  CHECK((stdx::fixed_soa_vector<int, double>(1, 1).size() == 1));
+  CHECK(throws_range_error([] { stdx::fixed_soa_vector<int, double>(1, 0); }));
+  stdx::fixed_soa_vector<int, double> soa(0, 3);
+  CHECK(throws_range_error([&] { soa.resize(1, 0); }));
+  CHECK(soa.size() == 4);
+  CHECK(stdx::concurrent_fixed_histogram<>(0, 0, 1).size() == 1);
+  CHECK(throws_range_error([] { stdx::concurrent_fixed_histogram<>(0, -1, 1); }));
+}
+
+void test_slide() {
+  stdx::fixed_vector<std::string> v(0, 4);
+  for (int64_t i = 0; i <= 4; ++i) { v[i] = std::to_string(i); }
+  v.slide(2, 7, "new");
+  CHECK(v.min_index() == 2 && v.max_index() == 7);
+  CHECK(v[2] == "2" && v[4] == "4" && v[5] == "new" && v[7] == "new");
+  v.slide(-1, 3, "old");
+  CHECK(v[-1] == "old" && v[1] == "old" && v[2] == "2" && v[3] == "3" && v.size() == 5);
+  v.slide(100, 101, "far");
+  CHECK(v[100] == "far" && v.size() == 2);
+
+  stdx::fixed_vector<int> empty;
+  empty.slide(0, 3, 9);
+  CHECK(empty.size() == 4 && empty[0] == 9 && empty[3] == 9);
+
+  stdx::ring_fixed_vector<int> ring;
+  ring.slide(0, 2, 1);
+  CHECK(ring.min_index() == 0 && ring[0] == 1 && ring[2] == 1);
+  ring[1] = 5;
+  ring.advance(1, 8);
+  CHECK(ring[1] == 5 && ring[3] == 8);
+}
+
+}
+
+int main() {
+  test_bounds();
+  test_slide();
+  return stdx_test::check_result();
+}
@@ -0,0 +1,148 @@
+//
+//  test_fixed_vector_nd.cpp
+//  test
+//
+//  Storage order and strides of fixed_vector_nd in both layouts, negative bounds, slices and their contiguity, checked access, and assign leaving the bounds unchanged when it throws.
+//
+
+#include <cstdint>
+#include <stdexcept>
+
+#include <stdx/fixed_vector_nd.hpp>
+
+#include "check.hpp"
+
+namespace {
+
+// Element whose copy constructor throws while armed
+struct fragile {
+  static inline bool armed = false;
+  int value = 0;
+  fragile() = default;
+  explicit fragile(int v) : value(v) { }
+  fragile(const fragile& other) : value(other.value) {
+    if (armed) { throw std::runtime_error("fragile"); }
+  }
+  fragile& operator=(const fragile&) = default;
+};
+
+template <class F>
+bool throws_out_of_range(F f) {
+  try { f(); } catch (const std::out_of_range&) { return true; }
+  return false;
+}
+
+void test_layout() {
+  stdx::fixed_vector_nd<int, 3> rows({0, 0, 0}, {1, 2, 3}, 0);
+  CHECK(rows.size() == 24);
+  CHECK(rows.stride(2) == 1 && rows.stride(1) == 4 && rows.stride(0) == 12);
+  rows(1, 2, 3) = 5;
+  rows(0, 1, 2) = 6;
+  CHECK(rows.data()[23] == 5 && rows.data()[6] == 6);
+
+  stdx::fixed_vector_nd<int, 3, stdx::layout::column_major> columns({0, 0, 0}, {1, 2, 3}, 0);
+  CHECK(columns.stride(0) == 1 && columns.stride(1) == 2 && columns.stride(2) == 6);
+  columns(1, 2, 3) = 5;
+  columns(1, 1, 2) = 6;
+  CHECK(columns.data()[23] == 5 && columns.data()[15] == 6);
+
+  // Storage order runs through the fastest dimension first
+  stdx::fixed_vector_nd<int, 2> grid({0, 0}, {2, 1});
+  int n = 0;
+  for (auto& x : grid) { x = n++; }
+  CHECK(grid(0, 1) == 1 && grid(1, 0) == 2 && grid(2, 1) == 5);
+}
+
+void test_negative_bounds() {
+  stdx::fixed_vector_nd<int, 2> v({-3, -1}, {-1, 2}, 0);
+  CHECK(v.size() == 12 && v.extent(0) == 3 && v.extent(1) == 4);
+  CHECK(v.min_index(0) == -3 && v.max_index(0) == -1 && v.min_index(1) == -1 && v.max_index(1) == 2);
+  for (int64_t i = -3; i <= -1; ++i) {
+    for (int64_t j = -1; j <= 2; ++j) { v(i, j) = static_cast<int>(i * 10 + j); }
+  }
+  CHECK(v.data()[0] == -31 && v.data()[11] == -8);
+  CHECK((v(-2, 0) == -20 && v[{-3, 2}] == -28));
+
+  const auto view = v.view();
+  CHECK(view(-1, -1) == -11 && view.data() == v.data() && view.size() == 12);
+}
+
+void test_slice() {
+  stdx::fixed_vector_nd<int, 2> v({-1, 10}, {1, 13}, 0);
+  for (int64_t i = -1; i <= 1; ++i) {
+    for (int64_t j = 10; j <= 13; ++j) { v(i, j) = static_cast<int>(i * 100 + j); }
+  }
+
+  // Fixing the slow dimension leaves a row of adjacent elements
+  auto row = v.slice(0, 1);
+  CHECK(row.min_index(0) == 10 && row.max_index(0) == 13 && row.size() == 4);
+  CHECK(row.is_contiguous() && row.data() == &v(1, 10));
+  CHECK(row[10] == 110 && row[13] == 113);
+  row[12] = -1;
+  CHECK(v(1, 12) == -1);
+
+  // Fixing the fast dimension leaves a strided column
+  auto column = v.slice(1, 11);
+  CHECK(column.min_index(0) == -1 && column.max_index(0) == 1 && column.stride(0) == 4);
+  CHECK(!column.is_contiguous());
+  CHECK(column[-1] == -89 && column[0] == 11 && column[1] == 111);
+
+  const auto& cv = v;
+  auto crow = cv.slice(0, -1);
+  CHECK(crow[13] == -87 && crow.is_contiguous());
+
+  stdx::fixed_vector_nd<int, 2, stdx::layout::column_major> cm({-1, 10}, {1, 13}, 0);
+  CHECK(cm.slice(1, 12).is_contiguous() && !cm.slice(0, 0).is_contiguous());
+
+  stdx::fixed_vector_nd<int, 3> cube({0, 0, 0}, {2, 2, 2}, 0);
+  cube(1, 2, 0) = 7;
+  auto plane = cube.slice(0, 1);
+  CHECK(plane(2, 0) == 7 && plane.slice(0, 2)[0] == 7 && plane.slice(0, 2).is_contiguous());
+}
+
+void test_at() {
+  stdx::fixed_vector_nd<int, 2> v({-1, 0}, {1, 2}, 3);
+  CHECK(v.at(-1, 0) == 3 && v.at(1, 2) == 3);
+  CHECK(throws_out_of_range([&] { v.at(-2, 0); }));
+  CHECK(throws_out_of_range([&] { v.at(2, 0); }));
+  CHECK(throws_out_of_range([&] { v.at(0, 3); }));
+  CHECK(throws_out_of_range([&] { v.at({0, -1}); }));
+  const auto& cv = v;
+  CHECK(throws_out_of_range([&] { cv.at(0, -1); }));
+  CHECK(throws_out_of_range([&] { v.view().at(1, 3); }));
+  CHECK(throws_out_of_range([&] { v.slice(0, 0).at(5); }));
+}
+
+// A failed assign keeps the old bounds and strides, so indexing still matches the storage
+void test_assign() {
+  stdx::fixed_vector_nd<int, 2> v({0, 0}, {1, 2}, 1);
+  v.assign({-2, -2}, {2, 2}, 4);
+  CHECK(v.size() == 25 && v(-2, -2) == 4 && v(2, 2) == 4 && v.stride(0) == 5);
+
+  bool threw = false;
+  try { v.assign({0, 0}, {3, -1}, 0); } catch (const std::range_error&) { threw = true; }
+  CHECK(threw);
+  CHECK(v.min_index(0) == -2 && v.max_index(1) == 2 && v.stride(0) == 5 && v.size() == 25);
+  v(2, 2) = 9;
+  CHECK(v.data()[24] == 9);
+
+  stdx::fixed_vector_nd<fragile, 2> f({0, 0}, {1, 1}, fragile(2));
+  fragile::armed = true;
+  threw = false;
+  try { f.assign({0, 0}, {9, 9}, fragile(3)); } catch (const std::runtime_error&) { threw = true; }
+  fragile::armed = false;
+  CHECK(threw);
+  CHECK(f.max_index(0) == 1 && f.max_index(1) == 1 && f.stride(0) == 2 && f.size() == 4);
+  CHECK(f(1, 1).value == 2);
+}
+
+}
+
+int main() {
+  test_layout();
+  test_negative_bounds();
+  test_slice();
+  test_at();
+  test_assign();
+  return stdx_test::check_result();
+}
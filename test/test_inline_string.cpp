@@ -0,0 +1,96 @@
+//
+//  test_inline_string.cpp
+//  test
+//
+//  Capacity checks of basic_inline_string, its std::hash specialisation, and assigning views of a string back to itself.
+//
+
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+#include <stdx/string_algorithms.hpp>
+
+#include "check.hpp"
+
+namespace {
+
+template <class F>
+bool throws_length_error(F f) {
+  try { f(); } catch (const std::length_error&) { return true; }
+  return false;
+}
+
+// Operations which would overflow throw and leave the string unchanged
+void test_overflow() {
+  using key = stdx::inline_string<8>;
+  CHECK(throws_length_error([] { key("123456789"); }));
+  CHECK(throws_length_error([] { key(9, 'x'); }));
+  CHECK(key("12345678").size() == 8);
+
+  key s("12345");
+  CHECK(throws_length_error([&] { s.append("6789"); }));
+  CHECK(throws_length_error([&] { s.append(4, '!'); }));
+  CHECK(throws_length_error([&] { s += std::string_view("abcd"); }));
+  CHECK(throws_length_error([&] { s.assign(std::string(9, 'y')); }));
+  CHECK(throws_length_error([&] { s = "a long string"; }));
+  CHECK(throws_length_error([&] { s.resize(9); }));
+  CHECK(throws_length_error([&] { s.reserve(9); }));
+  CHECK(s == "12345" && s.size() == 5 && s.c_str()[5] == '\0');
+
+  s.append("678");
+  CHECK(s == "12345678");
+  CHECK(throws_length_error([&] { s.push_back('9'); }));
+  CHECK(throws_length_error([&] { s += '9'; }));
+  CHECK(s == "12345678" && s.c_str()[8] == '\0');
+
+  const std::vector<std::string> parts{"abc", "def", "ghi"};
+  CHECK(key(",").join(parts.begin(), parts.begin() + 2) == "abc,def");
+  CHECK(throws_length_error([&] { key(",").join(parts); }));
+}
+
+void test_hash() {
+  const stdx::inline_string<16> a("key"), b(std::string("key"));
+  const std::hash<stdx::inline_string<16>> hasher;
+  CHECK(hasher(a) == hasher(b));
+  CHECK(hasher(a) == std::hash<std::string_view>()("key"));
+  CHECK(std::hash<stdx::inline_string<4>>()("key") == hasher(a));
+
+  std::unordered_set<stdx::inline_string<16>> keys{"alpha", "bravo", "alpha"};
+  CHECK(keys.size() == 2 && keys.count("bravo") == 1 && keys.count("charlie") == 0);
+}
+
+// Views returned by the string operations may be assigned back to the string they refer to
+void test_self_assign() {
+  stdx::inline_string<16> s("  padded  ");
+  s = s.strip();
+  CHECK(s == "padded" && s.size() == 6 && s.c_str()[6] == '\0');
+  s = "xxabcxx";
+  s = s.lstrip("x");
+  CHECK(s == "abcxx");
+  s = s.rstrip("x");
+  CHECK(s == "abc");
+  s = "0123456789";
+  s = s.view().substr(4, 3);
+  CHECK(s == "456");
+  s = s.view();
+  CHECK(s == "456");
+  s.assign(s.view().substr(1));
+  CHECK(s == "56" && s.c_str()[2] == '\0');
+
+  stdx::inline_string<16> blank("   ");
+  blank = blank.strip();
+  CHECK(blank.empty() && blank.c_str()[0] == '\0');
+}
+
+}
+
+int main() {
+  test_overflow();
+  test_hash();
+  test_self_assign();
+  return stdx_test::check_result();
+}
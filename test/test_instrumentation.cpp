@@ -0,0 +1,72 @@
+//
+//  test_instrumentation.cpp
+//  test
+//
+//  Counting of instrumented operations across threads, and resets made while other threads are counting. Built with STDX_INSTRUMENT defined.
+//
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <stdx/fixed_vector.hpp>
+#include <stdx/instrumentation.hpp>
+#include <stdx/string.hpp>
+
+#include "check.hpp"
+
+namespace {
+
+using stdx::instrumentation::operation;
+
+void test_counts() {
+  stdx::instrumentation::reset();
+  const stdx::string s("  padded  ");
+  for (int i = 0; i < 10; ++i) { (void)s.strip(); }
+  std::thread([&] { for (int i = 0; i < 5; ++i) { (void)s.strip(); } }).join();
+  const stdx::instrumentation::report counts = stdx::instrumentation::snapshot();
+  CHECK(counts[operation::strip].calls == 15);
+  CHECK(counts[operation::strip].bytes_scanned == 15 * 4);
+  CHECK(stdx::instrumentation::thread_snapshot()[operation::strip].calls == 10);
+
+  stdx::fixed_vector<int> v(0, 9);
+  stdx::instrumentation::reset();
+  v.resize(0, 999);
+  CHECK(stdx::instrumentation::snapshot()[operation::resize].calls == 1);
+  CHECK(stdx::instrumentation::snapshot()[operation::resize].allocations == 1);
+  stdx::instrumentation::reset();
+  CHECK(stdx::instrumentation::snapshot().total().calls == 0);
+  CHECK(stdx::instrumentation::thread_snapshot().total().calls == 0);
+}
+
+// A reset must not be undone by a thread that is counting at the same time
+void test_concurrent_reset() {
+  std::atomic<bool> stop(false);
+  std::atomic<int> started(0);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 2; ++t) {
+    threads.emplace_back([&] {
+      const stdx::string s(" x ");
+      (void)s.strip();
+      ++started;
+      while (!stop) { (void)s.strip(); }
+    });
+  }
+  while (started < 2) { std::this_thread::yield(); }
+  for (int i = 0; i < 1000; ++i) { stdx::instrumentation::reset(); }
+  stop = true;
+  for (std::thread& thread : threads) { thread.join(); }
+  const uint64_t after_stop = stdx::instrumentation::snapshot()[operation::strip].calls;
+  stdx::instrumentation::reset();
+  CHECK(stdx::instrumentation::snapshot()[operation::strip].calls == 0);
+  CHECK(after_stop < uint64_t(1) << 40);
+}
+
+}
+
+int main() {
+  CHECK(stdx::instrumentation::enabled());
+  test_counts();
+  test_concurrent_reset();
+  return stdx_test::check_result();
+}
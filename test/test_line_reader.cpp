@@ -0,0 +1,116 @@
+//
+//  test_line_reader.cpp
+//  test
+//
+//  Reading lines from mapped files, empty and procfs files, and pipes, and splitting them into fields.
+//
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <stdx/line_reader.hpp>
+
+#include "check.hpp"
+
+#include <unistd.h>
+
+namespace {
+
+std::string temp_file(const std::string& contents) {
+  char name[] = "/tmp/stdx_test_line_reader_XXXXXX";
+  const int fd = ::mkstemp(name);
+  CHECK(fd >= 0);
+  CHECK(::write(fd, contents.data(), contents.size()) == static_cast<::ssize_t>(contents.size()));
+  ::close(fd);
+  return name;
+}
+
+std::vector<std::string> read_all(stdx::line_reader& reader) {
+  std::vector<std::string> lines;
+  for (std::string_view line : reader) { lines.emplace_back(line); }
+  return lines;
+}
+
+void test_files() {
+  const std::string path = temp_file("one\r\ntwo\n\nlast");
+  stdx::line_reader mapped(path);
+  CHECK(mapped.is_mapped());
+  CHECK((read_all(mapped) == std::vector<std::string>{"one", "two", "", "last"}));
+  CHECK(mapped.line_number() == 4);
+  std::remove(path.c_str());
+
+  const std::string empty = temp_file("");
+  stdx::line_reader none(empty);
+  CHECK(!none.is_mapped() && read_all(none).empty());
+  std::remove(empty.c_str());
+
+  // Reports a size of zero, but has contents
+  if (std::FILE* status = std::fopen("/proc/self/status", "r")) {
+    std::fclose(status);
+    stdx::line_reader proc("/proc/self/status");
+    CHECK(!proc.is_mapped());
+    const std::vector<std::string> lines = read_all(proc);
+    CHECK(!lines.empty() && lines[0].compare(0, 5, "Name:") == 0);
+  }
+}
+
+// Each line must be returned once it is written, without waiting for the buffer to fill or the pipe to close
+void test_pipe() {
+  int fds[2];
+  CHECK(::pipe(fds) == 0);
+  std::FILE* in = ::fdopen(fds[0], "r");
+  std::atomic<int> received(0);
+  std::atomic<bool> timed_out(false);
+  std::thread writer([&] {
+    for (int i = 0; i < 3; ++i) {
+      const std::string line = "line " + std::to_string(i) + "\n";
+      CHECK(::write(fds[1], line.data(), line.size()) == static_cast<::ssize_t>(line.size()));
+      const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+      while (received.load() <= i && !timed_out) {
+        if (std::chrono::steady_clock::now() > deadline) { timed_out = true; }
+        std::this_thread::yield();
+      }
+    }
+    ::close(fds[1]);
+  });
+  stdx::line_reader reader(in, 4);
+  std::vector<std::string> lines;
+  for (std::string_view line : reader) {
+    lines.emplace_back(line);
+    ++received;
+  }
+  writer.join();
+  std::fclose(in);
+  CHECK(!timed_out);
+  CHECK((lines == std::vector<std::string>{"line 0", "line 1", "line 2"}));
+}
+
+void test_fields() {
+  const std::string path = temp_file("a, b ,c\n x ,,y\n");
+  stdx::field_reader commas(path, ',', false, true);
+  std::vector<std::string_view> fields;
+  CHECK(commas.next(fields));
+  CHECK((fields == std::vector<std::string_view>{"a", "b", "c"}));
+  CHECK(commas.next(fields));
+  CHECK((fields == std::vector<std::string_view>{"x", "", "y"}));
+  CHECK(!commas.next(fields) && commas.line_number() == 2);
+
+  stdx::field_reader words(path);
+  CHECK(words.next(fields));
+  CHECK((fields == std::vector<std::string_view>{"a,", "b", ",c"}));
+  std::remove(path.c_str());
+}
+
+}
+
+int main() {
+  test_files();
+  test_pipe();
+  test_fields();
+  return stdx_test::check_result();
+}
@@ -0,0 +1,133 @@
+//
+//  test_mapped_fixed_vector.cpp
+//  test
+//
+//  Saving fixed_vectors and mapping them back, including empty vectors, and rejection of corrupt files.
+//
+
+#include <algorithm>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#include <stdx/mapped_fixed_vector.hpp>
+
+#include "check.hpp"
+
+namespace {
+
+const std::string path = "/tmp/stdx_test_mapped_fixed_vector_" + std::to_string(::getpid());
+
+template <class F>
+bool throws_runtime_error(F f) {
+  try { f(); } catch (const std::system_error&) { return false; } catch (const std::runtime_error&) { return true; }
+  return false;
+}
+
+// Overwrite the bytes at \p offset of the saved file with \p bytes
+void patch(std::size_t offset, const void* bytes, std::size_t n) {
+  std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+  file.seekp(static_cast<std::streamoff>(offset));
+  file.write(static_cast<const char*>(bytes), static_cast<std::streamsize>(n));
+}
+
+void test_round_trip() {
+  stdx::fixed_vector<double> v(-5, 10);
+  for (int64_t i = -5; i <= 10; ++i) { v[i] = static_cast<double>(i) * 1.5; }
+  stdx::save(v, path);
+  stdx::mapped_fixed_vector<double> mapped(path, true);
+  CHECK(mapped.min_index() == -5 && mapped.max_index() == 10 && mapped.size() == 16);
+  CHECK(mapped[-5] == -7.5 && mapped.at(10) == 15 && mapped.front() == -7.5 && mapped.back() == 15);
+  CHECK(mapped.verify());
+  bool threw = false;
+  try { mapped.at(11); } catch (const std::out_of_range&) { threw = true; }
+  CHECK(threw);
+  const stdx::fixed_vector<double> copy = mapped.to_fixed_vector();
+  CHECK(copy.min_index() == -5 && copy.max_index() == 10 && std::equal(copy.begin(), copy.end(), v.begin(), v.end()));
+
+  // Saving again replaces the file, while the old mapping keeps its contents
+  v[0] = 99;
+  stdx::save(v, path);
+  CHECK(mapped[0] == 0);
+  CHECK(stdx::mapped_fixed_vector<double>(path)[0] == 99);
+}
+
+void test_empty() {
+  stdx::save(stdx::fixed_vector<int>(), path);
+  stdx::mapped_fixed_vector<int> defaulted(path, true);
+  CHECK(defaulted.empty() && defaulted.begin() == defaulted.end() && defaulted.to_fixed_vector().size() == 0);
+
+  const std::vector<int> none;
+  const stdx::fixed_vector<int> from_range(5, none.begin(), none.end());
+  CHECK(from_range.min_index() == 5 && from_range.max_index() == 4);
+  stdx::save(from_range, path);
+  stdx::mapped_fixed_vector<int> empty(path, true);
+  CHECK(empty.empty() && empty.min_index() == 5 && empty.max_index() == 4);
+  bool threw = false;
+  try { empty.at(5); } catch (const std::out_of_range&) { threw = true; }
+  CHECK(threw);
+}
+
+void test_corrupt() {
+  const stdx::fixed_vector<int32_t> v(1, 100, 7);
+  auto fresh = [&] { stdx::save(v, path); };
+  auto load = [] { stdx::mapped_fixed_vector<int32_t> mapped(path); };
+
+  fresh();
+  patch(0, "XTDX", 4);
+  CHECK(throws_runtime_error(load));
+
+  fresh();
+  const uint32_t version = 99;
+  patch(offsetof(stdx::fixed_vector_file_header, version), &version, sizeof(version));
+  CHECK(throws_runtime_error(load));
+
+  fresh();
+  CHECK(throws_runtime_error([] { stdx::mapped_fixed_vector<int64_t> wrong(path); }));
+  const uint64_t element_size = 8;
+  patch(offsetof(stdx::fixed_vector_file_header, element_size), &element_size, sizeof(element_size));
+  CHECK(throws_runtime_error(load));
+
+  fresh();
+  CHECK(::truncate(path.c_str(), sizeof(stdx::fixed_vector_file_header) + 99 * 4) == 0);
+  CHECK(throws_runtime_error(load));
+  CHECK(::truncate(path.c_str(), 10) == 0);
+  CHECK(throws_runtime_error(load));
+
+  // Bounds whose difference overflows int64_t
+  fresh();
+  const int64_t bounds[2] = {INT64_MIN, INT64_MAX};
+  patch(offsetof(stdx::fixed_vector_file_header, min_index), bounds, sizeof(bounds));
+  CHECK(throws_runtime_error(load));
+  const int64_t reversed[2] = {100, 1};
+  patch(offsetof(stdx::fixed_vector_file_header, min_index), reversed, sizeof(reversed));
+  CHECK(throws_runtime_error(load));
+
+  // A flipped payload byte is only found when the checksum is checked
+  fresh();
+  patch(sizeof(stdx::fixed_vector_file_header) + 17, "\x55", 1);
+  stdx::mapped_fixed_vector<int32_t> unchecked(path);
+  CHECK(!unchecked.verify());
+  CHECK(throws_runtime_error([] { stdx::mapped_fixed_vector<int32_t> checked(path, true); }));
+
+  bool threw = false;
+  try { stdx::mapped_fixed_vector<int32_t> missing(path + ".missing"); } catch (const std::system_error&) { threw = true; }
+  CHECK(threw);
+}
+
+}
+
+int main() {
+  test_round_trip();
+  test_empty();
+  test_corrupt();
+  std::remove(path.c_str());
+  return stdx_test::check_result();
+}
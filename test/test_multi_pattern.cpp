@@ -0,0 +1,110 @@
+//
+//  test_multi_pattern.cpp
+//  test
+//
+//  Matches of basic_multi_pattern against a naive leftmost-longest search.
+//
+
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <stdx/multi_pattern.hpp>
+
+#include "check.hpp"
+
+namespace {
+
+/* Leftmost match at or after \p pos, choosing the longest pattern there. */
+template <class CharT>
+stdx::pattern_match naive_find(std::basic_string_view<CharT> text, const std::vector<std::basic_string<CharT>>& patterns, std::size_t pos) {
+  for (std::size_t start = pos; start < text.size(); ++start) {
+    stdx::pattern_match best{static_cast<std::size_t>(-1), 0, 0};
+    for (std::size_t k = 0; k < patterns.size(); ++k) {
+      if (text.substr(start, patterns[k].size()) == patterns[k] && (!best || patterns[k].size() > best.length)) {
+        best = stdx::pattern_match{start, patterns[k].size(), k};
+      }
+    }
+    if (best) { return best; }
+  }
+  return stdx::pattern_match{static_cast<std::size_t>(-1), 0, 0};
+}
+
+template <class CharT>
+void check_all_matches(std::basic_string_view<CharT> text, const std::vector<std::basic_string<CharT>>& patterns) {
+  const stdx::basic_multi_pattern<CharT> set(patterns.begin(), patterns.end());
+  std::size_t expected_count = 0;
+  for (std::size_t pos = 0; pos <= text.size(); ++pos) {
+    const stdx::pattern_match expected = naive_find(text, patterns, pos);
+    const stdx::pattern_match actual = set.find(text, pos);
+    CHECK(actual.pos == expected.pos);
+    if (expected) {
+      CHECK(actual.length == expected.length);
+      CHECK(actual.pattern == expected.pattern);
+    }
+  }
+  for (stdx::pattern_match m = naive_find(text, patterns, 0); m; m = naive_find(text, patterns, m.pos + m.length)) { ++expected_count; }
+  CHECK(set.count(text) == expected_count);
+}
+
+void test_overlapping() {
+  // Patterns which are prefixes, suffixes and infixes of each other
+  const std::vector<std::string> patterns = {"he", "she", "his", "hers", "e", "s", "ershe"};
+  check_all_matches<char>("ushershehishers", patterns);
+  const stdx::multi_pattern set(patterns.begin(), patterns.end());
+  const stdx::pattern_match m = set.find("ushers");
+  CHECK(m.pos == 1 && m.length == 3 && m.pattern == 1);
+  // Longest at the leftmost position wins over an earlier-ending shorter match
+  const stdx::multi_pattern nested{"abcd", "bc", "a"};
+  const stdx::pattern_match n = nested.find("xabcd");
+  CHECK(n.pos == 1 && n.length == 4 && n.pattern == 0);
+  // Successive matches do not overlap
+  CHECK(stdx::multi_pattern{"aa"}.count("aaaaa") == 2);
+  CHECK(stdx::multi_pattern{"aba"}.count("ababababa") == 2);
+}
+
+void test_random() {
+  std::mt19937 rng(3);
+  for (int trial = 0; trial < 200; ++trial) {
+    std::vector<std::string> patterns(1 + rng() % 6);
+    for (std::string& p : patterns) {
+      p.resize(1 + rng() % 4);
+      for (char& c : p) { c = static_cast<char>('a' + rng() % 3); }
+    }
+    std::string text(rng() % 80, ' ');
+    for (char& c : text) { c = static_cast<char>('a' + rng() % 4); }
+    check_all_matches<char>(text, patterns);
+  }
+}
+
+void test_empty() {
+  const std::vector<std::string> none;
+  const stdx::multi_pattern set(none.begin(), none.end());
+  CHECK(set.size() == 0);
+  CHECK(!set.find("anything"));
+  CHECK(!set.find(""));
+  CHECK(set.count("anything") == 0);
+  bool threw = false;
+  try { stdx::multi_pattern bad{"a", ""}; } catch (const std::invalid_argument&) { threw = true; }
+  CHECK(threw);
+  CHECK(!stdx::multi_pattern{"abc"}.find(""));
+  CHECK(!stdx::multi_pattern{"abc"}.find("ab"));
+}
+
+void test_wide() {
+  // Code units above 255 are looked up by binary search
+  const std::vector<std::u16string> patterns = {u"中文", u"文", u"aé"};
+  check_all_matches<char16_t>(u"x中文文aé中", patterns);
+}
+
+}
+
+int main() {
+  test_overlapping();
+  test_random();
+  test_empty();
+  test_wide();
+  return stdx_test::check_result();
+}
@@ -0,0 +1,82 @@
+//
+//  test_parallel.cpp
+//  test
+//
+//  Cache line chunking for elements of every size, and the parallel loops over fixed_vector.
+//
+
+#include <array>
+#include <cstdint>
+#include <string>
+
+#include <stdx/parallel.hpp>
+
+#include "check.hpp"
+
+namespace {
+
+// Chunks must cover [0, size) in order, and every boundary between chunks must start a cache line of the storage
+template <std::size_t N>
+void check_chunks() {
+  using element = std::array<char, N>;
+  alignas(64) static element storage[1000];
+  for (std::size_t offset : {0, 1, 3}) {
+    const element* data = storage + offset;
+    for (std::size_t size : {0, 1, 5, 63, 64, 65, 500, 997}) {
+      for (unsigned threads : {1u, 3u, 8u}) {
+        stdx::detail::cache_line_chunks chunks(data, size, threads);
+        std::size_t expected = 0;
+        for (std::size_t c = 0; c < chunks.count(); ++c) {
+          auto [first, last] = chunks.bounds(c);
+          CHECK(first == expected && last > first);
+          if (first != 0) { CHECK(reinterpret_cast<std::uintptr_t>(data + first) % 64 == 0); }
+          expected = last;
+        }
+        CHECK(expected == size);
+      }
+    }
+  }
+}
+
+void test_chunks() {
+  check_chunks<1>();
+  check_chunks<4>();
+  check_chunks<8>();
+  check_chunks<12>();
+  check_chunks<24>();
+  check_chunks<40>();
+  check_chunks<64>();
+  check_chunks<96>();
+  check_chunks<100>();
+  check_chunks<128>();
+}
+
+struct no_default {
+  explicit no_default(long v) : value(v) { }
+  long value;
+};
+
+void test_loops() {
+  stdx::thread_pool pool(4);
+  stdx::fixed_vector<int> v(-500, 1500);
+  stdx::parallel_for_indexed(v, [](int64_t i, int& x) { x = static_cast<int>(i); }, pool);
+  bool ok = true;
+  for (int64_t i = -500; i <= 1500; ++i) { ok = ok && v[i] == i; }
+  CHECK(ok);
+
+  stdx::fixed_vector<std::string> out;
+  stdx::transform_indexed(v, out, [](int64_t i, int x) { return std::to_string(i + x); }, pool);
+  CHECK(out.min_index() == -500 && out.max_index() == 1500 && out[-3] == "-6" && out[1500] == "3000");
+
+  const no_default sum = stdx::reduce_indexed(v, no_default(0), [](no_default a, no_default b) { return no_default(a.value + b.value); },
+                                              [](int64_t, int x) { return no_default(x); }, pool);
+  CHECK(sum.value == (1500 * 1501 - 500 * 501) / 2);
+}
+
+}
+
+int main() {
+  test_chunks();
+  test_loops();
+  return stdx_test::check_result();
+}
@@ -0,0 +1,81 @@
+//
+//  test_pmr_string.cpp
+//  test
+//
+//  Strings produced from a pmr::string allocate from the same memory resource as the string they were produced from.
+//
+
+#include <iterator>
+#include <memory_resource>
+#include <tuple>
+#include <vector>
+
+#include <stdx/arena.hpp>
+#include <stdx/string.hpp>
+
+#include "check.hpp"
+
+namespace {
+
+void test_partition() {
+  stdx::pmr::arena<> arena;
+  const stdx::pmr::string s("key=value", arena.allocator<char>());
+  for (const char* separator : {"=", "missing"}) {
+    const auto [before, sep, after] = s.partition(separator);
+    CHECK(before.get_allocator() == s.get_allocator());
+    CHECK(sep.get_allocator() == s.get_allocator());
+    CHECK(after.get_allocator() == s.get_allocator());
+    const auto [rbefore, rsep, rafter] = s.rpartition(separator);
+    CHECK(rbefore.get_allocator() == s.get_allocator());
+    CHECK(rsep.get_allocator() == s.get_allocator());
+    CHECK(rafter.get_allocator() == s.get_allocator());
+  }
+  CHECK(std::get<0>(s.partition("missing")) == "key=value");
+  CHECK(std::get<2>(s.rpartition("missing")) == "key=value");
+}
+
+// With the default resource unable to allocate, any result which does not allocate from the arena throws
+void test_arena_results() {
+  stdx::pmr::arena<> arena(std::pmr::new_delete_resource());
+  std::pmr::memory_resource* previous = std::pmr::set_default_resource(std::pmr::null_memory_resource());
+  bool threw = false;
+  try {
+    const stdx::pmr::string s("   a line long enough to need the heap, with several words   ", arena.allocator<char>());
+    const std::pmr::polymorphic_allocator<char> alloc = s.get_allocator();
+
+    const stdx::pmr::string stripped = s.strip();
+    CHECK(stripped.get_allocator() == alloc && stripped.size() == 55);
+    CHECK(s.lstrip().get_allocator() == alloc && s.rstrip().get_allocator() == alloc);
+
+    std::vector<stdx::pmr::string> words;
+    stripped.split(std::back_inserter(words));
+    CHECK(words.size() == 11);
+    for (const stdx::pmr::string& word : words) { CHECK(word.get_allocator() == alloc); }
+    std::vector<stdx::pmr::string> clauses;
+    stripped.split(std::back_inserter(clauses), ',');
+    CHECK(clauses.size() == 2 && clauses[0].get_allocator() == alloc && clauses[1].get_allocator() == alloc);
+
+    const stdx::pmr::string sub = s.substr(3, 30);
+    CHECK(sub.get_allocator() == alloc && sub == "a line long enough to need the");
+    const stdx::pmr::string replaced = s.replace("long", "very long");
+    CHECK(replaced.get_allocator() == alloc && replaced.size() == s.size() + 5);
+    CHECK(s.replace("absent", "x").get_allocator() == alloc);
+
+    const stdx::pmr::string divider(" -- separating the joined words -- ", arena.allocator<char>());
+    const stdx::pmr::string joined = divider.join(words);
+    CHECK(joined.get_allocator() == alloc && joined.size() > 300);
+    CHECK(joined.startswith("a -- separating"));
+  } catch (const std::bad_alloc&) {
+    threw = true;
+  }
+  std::pmr::set_default_resource(previous);
+  CHECK(!threw);
+}
+
+}
+
+int main() {
+  test_partition();
+  test_arena_results();
+  return stdx_test::check_result();
+}
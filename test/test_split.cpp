@@ -0,0 +1,66 @@
+//
+//  test_split.cpp
+//  test
+//
+//  Lazy splitting at a separator character, at whitespace and at a class of separators, from either end.
+//
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <stdx/string.hpp>
+
+#include "check.hpp"
+
+namespace {
+
+template <class Range>
+std::vector<std::string> tokens(const Range& range) {
+  std::vector<std::string> result;
+  for (auto token : range) { result.emplace_back(token.begin(), token.end()); }
+  return result;
+}
+
+using strings = std::vector<std::string>;
+
+void test_separator() {
+  const stdx::string s("a,,b,c");
+  CHECK(tokens(s.split_lazy(',')) == (strings{"a", "b", "c"}));
+  CHECK(tokens(s.split_lazy(',', false)) == (strings{"a", "", "b", "c"}));
+  CHECK(tokens(s.split_lazy(',', false, 1)) == (strings{"a", ",b,c"}));
+  CHECK(tokens(s.rsplit_lazy(',', false, 1)) == (strings{"c", "a,,b"}));
+  CHECK(tokens(stdx::string("").split_lazy(',', false)) == (strings{""}));
+}
+
+void test_whitespace() {
+  const stdx::string s("  one \t two\nthree  ");
+  CHECK(tokens(s.split_lazy()) == (strings{"one", "two", "three"}));
+  // Whitespace mode always merges separators
+  CHECK(tokens(s.split_lazy(-1, false)) == (strings{"one", "two", "three"}));
+  CHECK(tokens(s.rsplit_lazy(-1, true, 1)) == (strings{"three", "  one \t two"}));
+  CHECK(tokens(stdx::string("   ").split_lazy()).empty());
+  const std::u16string wide(u"  x  y ");
+  CHECK(tokens(stdx::split_lazy(std::u16string_view(wide))).size() == 2);
+}
+
+void test_class() {
+  const stdx::char_class separators(",;");
+  const stdx::string s("a;b,,c");
+  const auto view = s.split_lazy(separators);
+  CHECK(tokens(view) == (strings{"a", "b", "c"}));
+  // Iterating again gives the same tokens
+  CHECK(tokens(view) == (strings{"a", "b", "c"}));
+  CHECK(tokens(s.split_lazy(separators, false)) == (strings{"a", "b", "", "c"}));
+  CHECK(tokens(stdx::rsplit_lazy(std::string_view(s), separators, true, 1)) == (strings{"c", "a;b"}));
+  CHECK(tokens(stdx::string_view_ex(s).split_lazy(stdx::char_classes<char>::digits)) == (strings{"a;b,,c"}));
+}
+
+}
+
+int main() {
+  test_separator();
+  test_whitespace();
+  test_class();
+  return stdx_test::check_result();
+}
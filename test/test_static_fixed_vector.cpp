@@ -0,0 +1,64 @@
+//
+//  test_static_fixed_vector.cpp
+//  test
+//
+//  static_fixed_vector built and read in constant expressions, negative indices, and the exceptions thrown by at() and the initialiser list constructor.
+//
+
+#include <cstdint>
+#include <stdexcept>
+
+#include <stdx/static_fixed_vector.hpp>
+
+#include "check.hpp"
+
+namespace {
+
+constexpr int64_t squares_sum() {
+  stdx::static_fixed_vector<int, -2, 2> v;
+  for (int64_t i = v.min_index(); i <= v.max_index(); ++i) { v[i] = static_cast<int>(i * i); }
+  v.at(0) = 10;
+  int64_t sum = 0;
+  for (int x : v) { sum += x; }
+  return sum + v.front() * 100 + v.back() * 1000;
+}
+static_assert(squares_sum() == 4 + 1 + 10 + 1 + 4 + 400 + 4000, "constexpr build and read");
+
+constexpr stdx::static_fixed_vector<int, -2, 2> primes{2, 3, 5};
+static_assert(primes[-2] == 2 && primes[0] == 5 && primes.at(2) == 0, "constexpr initialiser list");
+static_assert(primes.size() == 5 && primes.min_index() == -2 && primes.max_index() == 2, "constexpr bounds");
+static_assert(stdx::static_fixed_vector<char, 1, 3>('x').at(3) == 'x', "constexpr fill");
+
+void test_access() {
+  stdx::static_fixed_vector<int, -2, 2> v(7);
+  v[-2] = 1;
+  v.at(2) = 3;
+  CHECK(v.data()[0] == 1 && v.data()[4] == 3 && v[0] == 7);
+
+  bool threw = false;
+  try { v.at(3); } catch (const std::out_of_range&) { threw = true; }
+  CHECK(threw);
+  threw = false;
+  try { v.at(-3); } catch (const std::out_of_range&) { threw = true; }
+  CHECK(threw);
+  const auto& cv = v;
+  threw = false;
+  try { cv.at(INT64_MIN); } catch (const std::out_of_range&) { threw = true; }
+  CHECK(threw);
+}
+
+void test_initializer_list() {
+  stdx::static_fixed_vector<int, 0, 2> full{1, 2, 3};
+  CHECK(full[0] == 1 && full[2] == 3);
+  bool threw = false;
+  try { stdx::static_fixed_vector<int, 0, 2> v{1, 2, 3, 4}; (void)v; } catch (const std::range_error&) { threw = true; }
+  CHECK(threw);
+}
+
+}
+
+int main() {
+  test_access();
+  test_initializer_list();
+  return stdx_test::check_result();
+}
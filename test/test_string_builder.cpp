@@ -0,0 +1,133 @@
+//
+//  test_string_builder.cpp
+//  test
+//
+//  Appending pieces to basic_string_builder, dispatch of operator<<, take, and the passes and allocations made by join.
+//
+
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <stdx/string.hpp>
+#include <stdx/string_builder.hpp>
+
+#include "check.hpp"
+
+namespace {
+
+int allocations = 0;
+
+template <class T>
+struct counting_allocator {
+  using value_type = T;
+  counting_allocator() noexcept = default;
+  template <class U>
+  counting_allocator(const counting_allocator<U>&) noexcept { }
+  T* allocate(std::size_t n) {
+    ++allocations;
+    return std::allocator<T>().allocate(n);
+  }
+  void deallocate(T* p, std::size_t n) noexcept { std::allocator<T>().deallocate(p, n); }
+  template <class U>
+  friend bool operator==(const counting_allocator&, const counting_allocator<U>&) noexcept { return true; }
+  template <class U>
+  friend bool operator!=(const counting_allocator&, const counting_allocator<U>&) noexcept { return false; }
+};
+
+using counting_builder = stdx::basic_string_builder<char, std::char_traits<char>, counting_allocator<char>>;
+
+// Single pass iterator over an array, counting the times it is advanced
+struct single_pass {
+  using iterator_category = std::input_iterator_tag;
+  using value_type = std::string;
+  using difference_type = std::ptrdiff_t;
+  using pointer = const std::string*;
+  using reference = const std::string&;
+
+  const std::string* p;
+  int* steps;
+  reference operator*() const { return *p; }
+  single_pass& operator++() {
+    ++p;
+    ++*steps;
+    return *this;
+  }
+  bool operator==(const single_pass& other) const { return p == other.p; }
+  bool operator!=(const single_pass& other) const { return p != other.p; }
+};
+
+void test_append_number() {
+  stdx::string_builder b;
+  b.append_number(0).append_number(-42).push_back(' ').append_number(18446744073709551615ull);
+  b.push_back(' ').append_number(2.5).push_back(' ').append_number(-0.125f).push_back(' ').append_number(static_cast<short>(-7));
+  CHECK(b.view() == "0-42 18446744073709551615 2.5 -0.125 -7");
+
+  stdx::u32string_builder w;
+  w.append_number(-123).append_number(1.5);
+  CHECK(w.view() == U"-1231.5");
+}
+
+void test_stream() {
+  stdx::string_builder b;
+  const std::string s("str");
+  const std::string_view v("view");
+  b << 'c' << s << v << "lit" << 42 << ' ' << 3.25 << static_cast<unsigned char>(9) << stdx::string("x");
+  CHECK(b.view() == "cstrviewlit42 3.259x");
+  CHECK(b.size() == 20);
+
+  // A character of another width is a number
+  stdx::u16string_builder w;
+  w << u'a' << 'b' << std::u16string_view(u"cd");
+  CHECK(w.view() == u"a98cd");
+}
+
+void test_take() {
+  stdx::string_builder b(64);
+  CHECK(b.capacity() >= 64 && b.empty());
+  b << "a string long enough to be allocated on the heap";
+  const char* storage = b.view().data();
+  std::string taken = b.take();
+  CHECK(taken == "a string long enough to be allocated on the heap");
+  CHECK(taken.data() == storage);
+  CHECK(b.empty() && b.size() == 0 && b.view().empty() && b.str().empty());
+  b << "reused";
+  CHECK(b.view() == "reused" && taken.size() == 48);
+  CHECK(b.take() == "reused" && b.take().empty());
+}
+
+void test_join() {
+  const std::vector<std::string> words{"alpha", "bravo", "charlie", "delta", "echo"};
+
+  // Input ranges are read once, in a single pass
+  int steps = 0;
+  const single_pass first{words.data(), &steps}, last{words.data() + words.size(), &steps};
+  CHECK(stdx::join(std::string_view(", "), first, last) == "alpha, bravo, charlie, delta, echo");
+  CHECK(steps == 5);
+  std::istringstream in("1 2 3");
+  CHECK(stdx::string("+").join(std::istream_iterator<int>(in), std::istream_iterator<int>()) == "1+2+3");
+
+  // Forward ranges are measured first, so the builder allocates once
+  counting_builder b;
+  allocations = 0;
+  stdx::join_into(b, ", ", words.begin(), words.end());
+  CHECK(allocations == 1);
+  CHECK(b.view() == "alpha, bravo, charlie, delta, echo" && b.capacity() == b.size());
+  allocations = 0;
+  const counting_builder::string_type taken = b.take();
+  CHECK(allocations == 0 && taken.size() == 34 && b.empty());
+}
+
+}
+
+int main() {
+  test_append_number();
+  test_stream();
+  test_take();
+  test_join();
+  return stdx_test::check_result();
+}
@@ -0,0 +1,149 @@
+//
+//  test_string_pool.cpp
+//  test
+//
+//  Interning in the single threaded pool, and in the concurrent pool while other threads read it by id and look strings up, and pools allocating from a memory resource.
+//
+
+#include <algorithm>
+#include <atomic>
+#include <memory_resource>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <stdx/arena.hpp>
+#include <stdx/string_pool.hpp>
+
+#include "check.hpp"
+
+namespace {
+
+void test_string_pool() {
+  stdx::string_pool pool;
+  CHECK(pool.empty() && pool.find("a") == stdx::string_pool::npos);
+  std::vector<std::string> strings;
+  for (int i = 0; i < 5000; ++i) { strings.push_back("s" + std::to_string(i)); }
+  for (std::size_t i = 0; i < strings.size(); ++i) { CHECK(pool.intern(strings[i]) == i); }
+  for (std::size_t i = 0; i < strings.size(); ++i) {
+    CHECK(pool.intern(strings[i]) == i);
+    CHECK(pool.find(strings[i]) == i);
+    CHECK(pool.at(static_cast<stdx::string_pool::id_type>(i)) == strings[i]);
+  }
+  CHECK(pool.size() == strings.size());
+  CHECK(pool.intern("") == strings.size() && pool.at(static_cast<stdx::string_pool::id_type>(strings.size())).empty());
+  bool threw = false;
+  try { pool.at(static_cast<stdx::string_pool::id_type>(pool.size())); } catch (const std::out_of_range&) { threw = true; }
+  CHECK(threw);
+  pool.clear();
+  CHECK(pool.empty() && !pool.contains("s1") && pool.intern("s1") == 0);
+}
+
+// Writers intern overlapping ranges of strings while readers check that every id below size() can be read, and maps back to itself
+void test_concurrent_string_pool() {
+  constexpr int writers = 4, readers = 2, per_writer = 20000;
+  stdx::concurrent_string_pool pool(4);
+  std::atomic<bool> done(false);
+  std::atomic<int> reader_failures(0);
+  std::vector<std::thread> threads;
+  for (int r = 0; r < readers; ++r) {
+    threads.emplace_back([&] {
+      while (!done.load(std::memory_order_acquire)) {
+        const std::size_t size = pool.size();
+        for (std::size_t id = size > 64 ? size - 64 : 0; id < size; ++id) {
+          const auto str = pool.at(static_cast<stdx::concurrent_string_pool::id_type>(id));
+          if (str.empty() || str[0] != 's' || pool.find(str) != id) { ++reader_failures; }
+        }
+        if (size > 0 && pool.at(0).empty()) { ++reader_failures; }
+      }
+    });
+  }
+  // Ids returned by find may be passed to at as soon as they are returned, even while the thread adding the string is publishing them
+  threads.emplace_back([&] {
+    for (int i = 0; !done.load(std::memory_order_acquire); i = (i + 1) % per_writer) {
+      const std::string str = "s" + std::to_string(i);
+      const auto id = pool.find(str);
+      if (id != stdx::concurrent_string_pool::npos && (id >= pool.size() || pool.at(id) != str)) { ++reader_failures; }
+    }
+  });
+  std::vector<std::vector<stdx::concurrent_string_pool::id_type>> ids(writers);
+  for (int w = 0; w < writers; ++w) {
+    threads.emplace_back([&, w] {
+      for (int i = 0; i < per_writer; ++i) { ids[w].push_back(pool.intern("s" + std::to_string(w * per_writer / 2 + i))); }
+    });
+  }
+  for (std::size_t t = readers + 1; t < threads.size(); ++t) { threads[t].join(); }
+  done.store(true, std::memory_order_release);
+  for (int r = 0; r <= readers; ++r) { threads[r].join(); }
+
+  CHECK(reader_failures == 0);
+  const std::size_t distinct = (writers + 1) * per_writer / 2;
+  CHECK(pool.size() == distinct);
+  std::vector<bool> seen(distinct, false);
+  for (int w = 0; w < writers; ++w) {
+    for (int i = 0; i < per_writer; ++i) {
+      const auto id = ids[w][i];
+      CHECK(id < distinct && pool.at(id) == "s" + std::to_string(w * per_writer / 2 + i));
+      if (id < distinct) { seen[id] = true; }
+    }
+  }
+  CHECK(std::find(seen.begin(), seen.end(), false) == seen.end());
+  bool threw = false;
+  try { pool.at(static_cast<stdx::concurrent_string_pool::id_type>(distinct)); } catch (const std::out_of_range&) { threw = true; }
+  CHECK(threw);
+}
+
+// With the default resource unable to allocate, any storage not taken from the given resource throws
+void test_pmr_pools() {
+  std::pmr::synchronized_pool_resource shared(std::pmr::new_delete_resource());
+  stdx::pmr::arena<> arena(std::pmr::new_delete_resource());
+  std::pmr::memory_resource* previous = std::pmr::set_default_resource(std::pmr::null_memory_resource());
+  bool threw = false;
+  try {
+    constexpr int writers = 4, per_writer = 5000;
+    stdx::pmr::concurrent_string_pool pool(8, &shared);
+    CHECK(pool.get_allocator().resource() == &shared && pool.shards() == 8);
+    std::vector<std::thread> threads;
+    std::atomic<int> failures(0);
+    for (int w = 0; w < writers; ++w) {
+      threads.emplace_back([&, w] {
+        try {
+          for (int i = 0; i < per_writer; ++i) {
+            const std::string str = "p" + std::to_string(w * per_writer / 2 + i);
+            if (pool.at(pool.intern(str)) != str) { ++failures; }
+          }
+        } catch (...) {
+          ++failures;
+        }
+      });
+    }
+    for (std::thread& thread : threads) { thread.join(); }
+    CHECK(failures == 0);
+    CHECK(pool.size() == (writers + 1) * per_writer / 2);
+    CHECK(pool.find("p0") != stdx::pmr::concurrent_string_pool::npos && !pool.contains("q0"));
+
+    // A single shard allocates only under its lock, so it may use an arena
+    stdx::pmr::concurrent_string_pool single(1, arena.allocator<char>());
+    const std::string long_string(100000, 'x');
+    CHECK(single.intern("a") == 0 && single.intern(long_string) == 1 && single.intern("a") == 0);
+    for (int i = 0; i < 3000; ++i) { single.intern(std::to_string(i)); }
+    CHECK(single.at(1) == long_string && single.size() == 3002);
+
+    stdx::pmr::string_pool local(arena.allocator<char>());
+    CHECK(local.intern("a") == 0 && local.get_allocator().resource() == arena.resource());
+  } catch (const std::bad_alloc&) {
+    threw = true;
+  }
+  std::pmr::set_default_resource(previous);
+  CHECK(!threw);
+}
+
+}
+
+int main() {
+  test_string_pool();
+  test_concurrent_string_pool();
+  test_pmr_pools();
+  return stdx_test::check_result();
+}
@@ -0,0 +1,154 @@
+//
+//  test_utf.cpp
+//  test
+//
+//  UTF-8 validation and transcoding, with invalid sequences placed after ASCII runs of each length, so they are found by both the SIMD and scalar paths.
+//
+
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <stdx/utf.hpp>
+
+#include "check.hpp"
+
+namespace {
+
+const std::size_t prefix_lengths[] = {0, 1, 7, 15, 16, 17, 31, 32, 33, 47, 64, 65};
+
+const std::vector<std::string> invalid_sequences = {
+  // Overlong encodings
+  "\xc0\x80", "\xc1\xbf", "\xe0\x80\x80", "\xe0\x9f\xbf", "\xf0\x80\x80\x80", "\xf0\x8f\xbf\xbf",
+  // Surrogates
+  "\xed\xa0\x80", "\xed\xbf\xbf", "\xed\xb0\x80",
+  // Above U+10FFFF, and bytes which never occur
+  "\xf4\x90\x80\x80", "\xf5\x80\x80\x80", "\xf7\xbf\xbf\xbf", "\xf8\x88\x80\x80\x80", "\xfe", "\xff",
+  // Lone and misplaced continuation bytes
+  "\x80", "\xbf", "\xc2\x41", "\xe2\x28\xa1", "\xe2\x82\x28", "\xf0\x9f\x98\x41",
+};
+const std::vector<std::string> truncated_sequences = {"\xc2", "\xe2\x82", "\xe0\xa0", "\xf0\x9f\x98", "\xf4\x8f", "\xf0"};
+const std::vector<std::pair<std::string, char32_t>> valid_sequences = {
+  {"\x7f", 0x7f}, {"\xc2\x80", 0x80}, {"\xdf\xbf", 0x7ff}, {"\xe0\xa0\x80", 0x800}, {"\xed\x9f\xbf", 0xd7ff},
+  {"\xee\x80\x80", 0xe000}, {"\xef\xbf\xbf", 0xffff}, {"\xf0\x90\x80\x80", 0x10000}, {"\xf4\x8f\xbf\xbf", 0x10ffff},
+};
+
+void test_validation() {
+  for (std::size_t k : prefix_lengths) {
+    const std::string prefix(k, 'a'), suffix(40, 'z');
+    for (const std::string& bad : invalid_sequences) {
+      CHECK(stdx::find_invalid_utf8(prefix + bad + suffix) == k);
+      CHECK(stdx::find_invalid_utf8(prefix + bad) == k);
+      CHECK(!stdx::is_valid_utf8(prefix + bad + suffix));
+    }
+    for (const std::string& bad : truncated_sequences) {
+      // At the end of the input, and cut short by ASCII
+      CHECK(stdx::find_invalid_utf8(prefix + bad) == k);
+      CHECK(stdx::find_invalid_utf8(prefix + bad + suffix) == k);
+    }
+    for (const auto& [good, cp] : valid_sequences) {
+      const std::string text = prefix + good + suffix;
+      CHECK(stdx::is_valid_utf8(text));
+      CHECK(stdx::utf8_length(text) == k + 1 + suffix.size());
+      // A valid sequence followed by an invalid one is reported at the invalid one
+      CHECK(stdx::find_invalid_utf8(prefix + good + "\x80") == k + good.size());
+    }
+  }
+  CHECK(stdx::is_valid_utf8(""));
+}
+
+void test_ascii_run() {
+  for (std::size_t n = 0; n <= 80; ++n) {
+    const std::string ascii(n, 'q');
+    const auto* u = reinterpret_cast<const unsigned char*>(ascii.data());
+    CHECK(stdx::detail::ascii_run(ascii.data(), n) == n);
+    for (std::size_t pos = 0; pos < n; ++pos) {
+      std::string s = ascii;
+      s[pos] = '\x80';
+      u = reinterpret_cast<const unsigned char*>(s.data());
+      CHECK(stdx::detail::ascii_run_scalar(u, n) == pos);
+#ifdef STDX_X86_SIMD
+      CHECK(stdx::detail::ascii_run_sse2(u, n) == pos);
+      if (stdx::detail::cpu_has_avx2()) { CHECK(stdx::detail::ascii_run_avx2(u, n) == pos); }
+#endif
+      CHECK(stdx::detail::ascii_run(s.data(), n) == pos);
+    }
+  }
+}
+
+void test_decode() {
+  for (const auto& [good, cp] : valid_sequences) {
+    std::size_t i = 0;
+    CHECK(stdx::detail::utf_decode(good.data(), good.size(), i) == cp);
+    CHECK(i == good.size());
+    char encoded[4];
+    CHECK(std::string(encoded, stdx::detail::utf_encode(cp, encoded)) == good);
+  }
+  for (const std::string& bad : invalid_sequences) {
+    std::size_t i = 0;
+    CHECK(stdx::detail::utf_decode(bad.data(), bad.size(), i) == stdx::detail::utf_invalid);
+    CHECK(i == 0);
+  }
+  // Every code point round trips through each encoding
+  for (char32_t cp = 0; cp <= 0x10ffff; cp += (cp < 0x11000 ? 1 : 97)) {
+    if (cp >= 0xd800 && cp <= 0xdfff) { continue; }
+    const std::u32string one(1, cp);
+    const std::string utf8 = stdx::utf32_to_utf8(one);
+    CHECK(stdx::is_valid_utf8(utf8));
+    CHECK(stdx::utf8_to_utf32(utf8) == one);
+    CHECK(stdx::utf16_to_utf32(stdx::utf8_to_utf16(utf8)) == one);
+  }
+}
+
+void test_transcode_errors() {
+  for (std::size_t k : prefix_lengths) {
+    for (const std::string& bad : invalid_sequences) {
+      std::u16string out = u"kept";
+      bool threw = false;
+      try { stdx::utf_transcode(std::string_view(std::string(k, 'a') + bad), out); } catch (const std::range_error&) { threw = true; }
+      CHECK(threw);
+      CHECK(out == u"kept");
+    }
+  }
+  // Unpaired surrogates and out of range code points in UTF-16 and UTF-32
+  for (std::u16string bad : {std::u16string(1, char16_t(0xd800)), std::u16string(1, char16_t(0xdc00)), std::u16string(u"a") + char16_t(0xd83d) + u"b"}) {
+    bool threw = false;
+    try { stdx::utf16_to_utf8(bad); } catch (const std::range_error&) { threw = true; }
+    CHECK(threw);
+  }
+  for (char32_t bad : {char32_t(0xd800), char32_t(0x110000), char32_t(0xffffffff)}) {
+    bool threw = false;
+    try { stdx::utf32_to_utf8(std::u32string(1, bad)); } catch (const std::range_error&) { threw = true; }
+    CHECK(threw);
+  }
+}
+
+void test_whitespace() {
+  const std::string text = "\xe3\x80\x80\xc2\xa0 word\xe2\x80\xa8 two\xe2\x80\x8b\xc2\x85";
+  CHECK(stdx::utf8_strip(text) == "word\xe2\x80\xa8 two\xe2\x80\x8b");  // U+200B is not whitespace
+  std::vector<std::string_view> tokens(stdx::utf8_split_view(text).begin(), stdx::utf8_split_view(text).end());
+  CHECK(tokens.size() == 2 && tokens[0] == "word" && tokens[1] == "two\xe2\x80\x8b");
+
+  // A truncated sequence which would be whitespace if complete must not take the following character with it
+  for (const char* next : {"A", " ", "\t", "\x7f"}) {
+    const std::string truncated = std::string(" \xe2\x80") + next + "BC";
+    CHECK(stdx::utf8_lstrip(truncated) == truncated.substr(1));
+    std::vector<std::string_view> parts(stdx::utf8_split_view(truncated).begin(), stdx::utf8_split_view(truncated).end());
+    const bool space = next[0] == ' ' || next[0] == '\t';
+    CHECK(parts.size() == (space ? 2u : 1u));
+    CHECK(parts[0] == (space ? std::string_view("\xe2\x80") : std::string_view(truncated).substr(1)));
+  }
+  CHECK(stdx::utf8_strip(std::string_view("\xe2\x80" "ABC")) == "\xe2\x80" "ABC");
+}
+
+}
+
+int main() {
+  test_validation();
+  test_ascii_run();
+  test_decode();
+  test_transcode_errors();
+  test_whitespace();
+  return stdx_test::check_result();
+}